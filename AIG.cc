@@ -0,0 +1,228 @@
+#include "AIG.hpp"
+#include "Set.hpp"
+#include "Optional.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+using std::ostream;
+using std::string;
+using std::swap;
+
+const uint32_t AIG::falseLit;
+const uint32_t AIG::trueLit;
+
+uint32_t AIG::addInput(const string& name)
+{
+	if (!_gates.empty())
+		throw std::logic_error("AIG inputs must be added before the gates");
+
+	_inputCount++;
+	_inputNames.push_back(name);
+
+	return 2 * _inputCount;
+}
+
+uint32_t AIG::andGate(uint32_t a, uint32_t b)
+{
+	if (a < b)
+		swap(a, b);
+
+	/* Constant propagation and trivial cases, b is the smaller literal */
+	if (b == falseLit || a == (b ^ 1))
+		return falseLit;
+	if (b == trueLit || a == b)
+		return a;
+
+	uint64_t key = (uint64_t(a) << 32) | b;
+	auto it = _unique.find(key);
+
+	if (it != _unique.end())
+		return it->second;
+
+	uint32_t lhs = 2 * (_inputCount + _gates.size() + 1);
+
+	_gates.push_back({ lhs, a, b });
+	_unique[key] = lhs;
+
+	return lhs;
+}
+
+uint32_t AIG::orGate(uint32_t a, uint32_t b)
+{
+	return andGate(a ^ 1, b ^ 1) ^ 1;
+}
+
+uint32_t AIG::andAll(Vector<uint32_t> lits)
+{
+	if (lits.empty())
+		return trueLit;
+
+	while (lits.size() > 1)
+	{
+		Vector<uint32_t> next;
+
+		for (size_t k = 0; k + 1 < lits.size(); k += 2)
+			next.push_back(andGate(lits[k], lits[k + 1]));
+
+		if (lits.size() % 2 == 1)
+			next.push_back(lits.back());
+
+		lits = next;
+	}
+
+	return lits[0];
+}
+
+void AIG::addOutput(uint32_t lit, const string& name)
+{
+	_outputs.push_back(lit);
+	_outputNames.push_back(name);
+}
+
+size_t AIG::inputCount() const
+{
+	return _inputCount;
+}
+
+size_t AIG::andCount() const
+{
+	return _gates.size();
+}
+
+void AIG::writeAIGER(ostream& out) const
+{
+	/* Deltas are written 7 bits at a time, low bits first, with the high bit set on all but the last byte */
+	auto writeDelta = [&out] (uint32_t delta)
+	{
+		while (delta >= 0x80)
+		{
+			out.put(char((delta & 0x7f) | 0x80));
+			delta >>= 7;
+		}
+
+		out.put(char(delta));
+	};
+
+	out << "aig " << _inputCount + _gates.size() << " " << _inputCount << " 0 "
+	    << _outputs.size() << " " << _gates.size() << "\n";
+
+	for (uint32_t lit : _outputs)
+		out << lit << "\n";
+
+	for (const Gate& gate : _gates)
+	{
+		writeDelta(gate.lhs - gate.rhs0);
+		writeDelta(gate.rhs0 - gate.rhs1);
+	}
+
+	for (size_t k = 0; k < _inputNames.size(); k++)
+		out << "i" << k << " " << _inputNames[k] << "\n";
+
+	for (size_t k = 0; k < _outputNames.size(); k++)
+		out << "o" << k << " " << _outputNames[k] << "\n";
+
+	out << "c\nGenerated by bafsyn\n";
+}
+
+AIG modelCircuit(const Model& model, const TrivialSpec& f1, const CNFSpec& spec)
+{
+	AIG aig;
+	Map<BVar, uint32_t> inputLit;
+
+	for (BVar x : spec.inputVars())
+		inputLit[x] = aig.addInput("x" + std::to_string(x));
+
+	Map<BVar, CNFClause> negDefinitionOf;
+
+	f1.forEach([&] (BVar z, const CNFClause& negDefinition)
+	{
+		negDefinitionOf[z] = negDefinition;
+	});
+
+	/* Gates are only built when some output needs them, so the graph has no dangling gates */
+	Map<BVar, uint32_t> indicatorLit;
+
+	auto indicator = [&] (BVar z) -> uint32_t
+	{
+		auto it = indicatorLit.find(z);
+
+		if (it != indicatorLit.end())
+			return it->second;
+
+		/* z_i is true iff every literal of X_i is false */
+		Vector<uint32_t> lits;
+
+		for (BLit lit : negDefinitionOf.at(z))
+			lits.push_back(inputLit.at(abs(lit)) ^ ((lit > 0) ? 1 : 0));
+
+		return indicatorLit[z] = aig.andAll(lits);
+	};
+
+	Map<BVar, uint32_t> outputLit;
+
+	for (size_t c = 0; c < model.componentCount(); c++)
+	{
+		const Set<BVar>& component = model.allComponents()[c];
+		const Vector<Set<BVar>>& entries = model.mssForComponent(c);
+
+		if (entries.empty())
+			continue;
+
+		/* Condition of every entry: no indicator outside it is true */
+		Vector<Optional<uint32_t>> conditionLit(entries.size());
+
+		auto condition = [&] (size_t j) -> uint32_t
+		{
+			if (!conditionLit[j])
+			{
+				Vector<uint32_t> lits;
+
+				for (BVar z : component)
+					if (entries[j].find(z) == entries[j].end())
+						lits.push_back(indicator(z) ^ 1);
+
+				conditionLit[j] = aig.andAll(lits);
+			}
+
+			return *conditionLit[j];
+		};
+
+		Set<BVar> outputs; /*< outputs set by some entry of the component */
+
+		for (const Set<BVar>& mss : entries)
+			for (BVar var : mss)
+				if (spec.outputVars().find(var) != spec.outputVars().end())
+					outputs.insert(var);
+
+		/* y = ITE(c_0, v_0, ITE(c_1, v_1, ... v_n-1)), where ITE(c, 1, e) = c | e and ITE(c, 0, e) = ~c & e */
+		for (BVar y : outputs)
+		{
+			bool lastValue = entries.back().find(y) != entries.back().end();
+			uint32_t lit = lastValue ? AIG::trueLit : AIG::falseLit;
+
+			for (size_t j = entries.size() - 1; j-- > 0;)
+			{
+				bool value = entries[j].find(y) != entries[j].end();
+
+				if (lit == (value ? AIG::trueLit : AIG::falseLit))
+					continue; /*< both branches agree, the condition is not needed */
+
+				if (value)
+					lit = aig.orGate(condition(j), lit);
+				else
+					lit = aig.andGate(condition(j) ^ 1, lit);
+			}
+
+			outputLit[y] = lit;
+		}
+	}
+
+	for (BVar y : spec.outputVars())
+	{
+		auto it = outputLit.find(y);
+		aig.addOutput((it != outputLit.end()) ? it->second : AIG::falseLit, "y" + std::to_string(y));
+	}
+
+	return aig;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CNFFormula.hpp"
+#include "CNFSpec.hpp"
+#include "TrivialSpec.hpp"
+#include "Model.hpp"
+#include "Vector.hpp"
+#include "Map.hpp"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/**
+ * And-inverter graph, written in the binary AIGER format.
+ *
+ * Literals follow AIGER: 2 * v for node v and 2 * v + 1 for its negation, with node 0 the
+ * constant false, so literal 1 is true. Inputs are nodes 1, ..., I and AND gates follow.
+ * Gates are hashed structurally on their (ordered) fanins and simplified with constant
+ * propagation and the rules a & a = a and a & ~a = 0, so equal subterms are built once.
+ */
+class AIG
+{
+	struct Gate
+	{
+		uint32_t lhs;
+		uint32_t rhs0; /*< rhs0 >= rhs1, as required by the binary format */
+		uint32_t rhs1;
+	};
+
+	size_t _inputCount = 0;
+	Vector<Gate> _gates;
+	Map<uint64_t, uint32_t> _unique; /*< gate literal by (rhs0, rhs1) */
+	Vector<uint32_t> _outputs;
+	Vector<std::string> _inputNames;
+	Vector<std::string> _outputNames;
+
+public:
+
+	static const uint32_t falseLit = 0;
+	static const uint32_t trueLit = 1;
+
+	/** Adds an input, all inputs must be added before the first gate */
+	uint32_t addInput(const std::string& name);
+
+	/** Literal of a & b */
+	uint32_t andGate(uint32_t a, uint32_t b);
+
+	/** Literal of a | b */
+	uint32_t orGate(uint32_t a, uint32_t b);
+
+	/** Literal of the AND of all given literals (true if there are none), as a balanced tree */
+	uint32_t andAll(Vector<uint32_t> lits);
+
+	void addOutput(uint32_t lit, const std::string& name);
+
+	size_t inputCount() const;
+	size_t andCount() const;
+
+	/** Writes the graph in binary AIGER format, with a symbol table */
+	void writeAIGER(std::ostream& out) const;
+};
+
+/**
+ * Builds the circuit of the synthesized function: one input for every input variable and
+ * one output for every output variable of the specification, by increasing variable.
+ *
+ * Every z_i <-> ~X_i becomes one AND of negated inputs, the condition of every entry is
+ * the AND of ~z_d over the indicators outside it, and every output is the decision list
+ * of its component as a chain of multiplexers with constant data inputs, which reduce to
+ * single gates. The last entry of a list needs no condition, since the model covers every
+ * input.
+ */
+AIG modelCircuit(const Model& model, const TrivialSpec& f1, const CNFSpec& spec);
@@ -0,0 +1,1126 @@
+#include "Algorithm.hpp"
+#include "Set.hpp"
+#include "Vector.hpp"
+#include "CNFFormula.hpp"
+#include "MFSGenerator.hpp"
+#include "MSSGenerator.hpp"
+#include "Printing.hpp"
+#include "CoverageWeights.hpp"
+#include "SPSCQueue.hpp"
+#include "TinyComponent.hpp"
+#include "Simulator.hpp"
+#include "ConeEnumeration.hpp"
+#include "ListMinimization.hpp"
+#include "Isomorphism.hpp"
+#include "ComponentCache.hpp"
+#include "Incremental.hpp"
+#include "Checkpoint.hpp"
+
+#include <stdexcept>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <exception>
+#include <numeric>
+#include <algorithm>
+#include <chrono>
+
+/**
+ * Throws SynthesisCancelled if the caller asked synthesis to stop.
+ */
+void checkCancelled(const SynthesisOptions& options)
+{
+  if (options.cancel && options.cancel->load(std::memory_order_relaxed))
+    throw SynthesisCancelled();
+}
+
+/**
+ * Writes the model to the checkpoint, if any and if it is due, while the list of the last
+ * component is still being computed.
+ */
+void checkpointIfDue(const Model& model, const SynthesisOptions& options)
+{
+  if (options.checkpoint)
+    options.checkpoint->update(model, false);
+}
+
+/**
+ * Computes a new MSS covering the given MFS, and stores the MSS in the model.
+ * - componentId: Identifier for the component the MSS will be associated with.
+ * - mfs: MFS that is not covered by any MSS in the model yet.
+ * - mssGen: MSS generator.
+ * - model: Function being synthesized. New MSS will be stored here.
+ * - coverage: If not null, soft clauses are weighted toward indicators likely to appear in uncovered MFS.
+ * Returns the new MSS.
+ */
+Set<BVar> storeMSSCovering(size_t componentId,
+			   const Set<BVar>& mfs,
+			   MSSGenerator& mssGen,
+			   Model& model,
+			   CoverageWeights* coverage)
+{
+#if MYDEBUG >=2  
+  printf("Printing MFS:");
+  print(mfs, "x");
+  printf("\n");
+#endif      
+
+  /* Generate an new MSS covering the MFS */
+  Optional<Set<BVar>> mss;
+
+  if (coverage)
+    mss = mssGen.newMSSCovering(mfs, coverage->weights());
+  else
+    mss = mssGen.newMSSCovering(mfs);
+      
+  if (!mss)
+  {
+    /* This branch will never be reached if the specification is realizable */
+    throw Unrealizable();
+  }
+
+#if MYDEBUG >=2        
+  printf("Printing MSS:");
+  print(*mss, "z");
+  printf("\n");
+#endif        
+        
+  if (coverage)
+    coverage->recordMSS(*mss);
+
+  model.addMSS(componentId, *mss);
+
+  return *mss;
+}
+
+/**
+ * Computes a new MSS covering a not-yet-covered MFS, and stored the MSS in the model.
+ * - componentId: Identifier for the component the MSS will be associated with.
+ * - mfsGen: MFS generator.
+ * - mssGen: MSS generator.
+ * - model: Function being synthesized, keeps track of the components and MSS associated with it. New MSS will be stored here.
+ * - coverage: If not null, soft clauses are weighted toward indicators likely to appear in uncovered MFS.
+ */
+bool computeAndStoreNextMSS(size_t componentId,
+			    MFSGenerator& mfsGen,
+			    MSSGenerator& mssGen,
+			    Model& model,
+			    CoverageWeights* coverage = nullptr)
+{
+  /*
+   * Generate an MFS (represented as a set of indicator variables) that
+   * has not been covered yet, or nothing if all MFS have been covered.
+   */
+  Optional<Set<BVar>> mfs = mfsGen.newMFS();
+   
+  if (!mfs)
+  {
+    return false; /*< no MFS left, indicate that enumeration has finished */
+  }
+  else
+  {
+    Set<BVar> mss = storeMSSCovering(componentId, *mfs, mssGen, model, coverage);
+    mfsGen.blockMSS(mss);
+
+    return true; /*< continue searching for maximal cliques */
+  }
+}
+
+/**
+ * Covers the MFS observed in simulation before the SAT-driven loop starts.
+ * - indices: Indices of the definitions (vertices of the conflict graph) in the component.
+ * - conflictGraph: Conflict graph restricted to the component.
+ * - simulation: simulation[r][i] holds the lanes of round r where z_i is true (see Simulator).
+ * The z_i true in a lane form an independent set of the conflict graph, which is extended
+ * greedily to a maximal one, i.e. an MFS. Every such MFS not covered yet gets an MSS, which
+ * is blocked in the MFS generator so that the SAT calls only have to find the remaining MFS.
+ */
+void seedFromSimulation(size_t componentId,
+			const Set<size_t>& indices,
+			const Graph<size_t>& conflictGraph,
+			const Vector<BVar>& indicatorVars,
+			const Vector<Vector<uint64_t>>& simulation,
+			MFSGenerator& mfsGen,
+			MSSGenerator& mssGen,
+			Model& model,
+			CoverageWeights* coverage)
+{
+  /* Definitions of the component by local position, with their neighbors */
+  Vector<size_t> vertices(indices.begin(), indices.end());
+  Map<size_t, size_t> position;
+
+  for (size_t p = 0; p < vertices.size(); p++)
+    position[vertices[p]] = p;
+
+  Vector<Vector<size_t>> adjacent(vertices.size());
+  Vector<bool> selfLoop(vertices.size());
+
+  for (size_t p = 0; p < vertices.size(); p++)
+  {
+    for (size_t j : conflictGraph.neighbors(vertices[p]))
+      adjacent[p].push_back(position.at(j));
+
+    selfLoop[p] = conflictGraph.edgeExists(vertices[p], vertices[p]);
+  }
+
+  Set<Vector<bool>> seen; /*< falsified sets already extended */
+
+  for (const Vector<uint64_t>& lanes : simulation)
+  {
+    for (size_t lane = 0; lane < 64; lane++)
+    {
+      Vector<bool> chosen(vertices.size(), false);
+
+      for (size_t p = 0; p < vertices.size(); p++)
+        chosen[p] = (lanes[vertices[p]] >> lane) & 1;
+
+      if (!seen.insert(chosen).second)
+        continue;
+
+      Vector<bool> excluded(vertices.size(), false); /*< vertices adjacent to a chosen vertex */
+
+      for (size_t p = 0; p < vertices.size(); p++)
+        if (chosen[p])
+          for (size_t q : adjacent[p])
+            excluded[q] = true;
+
+      /* Extend to a maximal independent set (vertices with a self-loop are never falsifiable) */
+      for (size_t p = 0; p < vertices.size(); p++)
+      {
+        if (!chosen[p] && !excluded[p] && !selfLoop[p])
+        {
+          chosen[p] = true;
+
+          for (size_t q : adjacent[p])
+            excluded[q] = true;
+        }
+      }
+
+      Set<BVar> mfs;
+
+      for (size_t p = 0; p < vertices.size(); p++)
+        if (chosen[p])
+          mfs.insert(indicatorVars[vertices[p]]);
+
+      if (model.alreadyCovered(componentId, mfs))
+        continue;
+
+      Set<BVar> mss = storeMSSCovering(componentId, mfs, mssGen, model, coverage);
+      mfsGen.blockMSS(mss);
+    }
+  }
+}
+
+/**
+ * Pipelined version of the loop calling computeAndStoreNextMSS.
+ *
+ * A producer thread runs ahead of the MaxSAT calls: every MFS it finds is blocked
+ * in its own solver and pushed to a queue of candidates. The calling thread drains
+ * the queue, computing an MSS for every candidate and sending the MSS back to the
+ * producer to be blocked as well. Candidates that became covered by an MSS found
+ * after they were queued are discarded before any MaxSAT call is spent on them.
+ *
+ * Every MFS is either blocked by an MSS in the model or queued as a candidate,
+ * so when the producer runs out of MFS and the queue is empty, all MFS are covered.
+ */
+void pipelinedMSSLoop(size_t componentId,
+		      MFSGenerator& mfsGen,
+		      MSSGenerator& mssGen,
+		      Model& model,
+		      const SynthesisOptions& options,
+		      CoverageWeights* coverage)
+{
+	SPSCQueue<Set<BVar>> candidates(options.pipelineDepth); /*< MFS sent from the producer to the consumer */
+	SPSCQueue<Set<BVar>> found(options.pipelineDepth); /*< MSS sent from the consumer to the producer */
+
+	std::atomic<bool> producerDone(false);
+	std::atomic<bool> stop(false); /*< set by the consumer if it fails */
+	std::exception_ptr producerError;
+
+	std::thread producer([&] ()
+	{
+		try
+		{
+			Set<BVar> mss;
+
+			/* Block every MSS sent back by the consumer */
+			auto drainFound = [&] ()
+			{
+				while (found.tryPop(mss))
+					mfsGen.blockMSS(mss);
+			};
+
+			while (!stop.load(std::memory_order_relaxed))
+			{
+				drainFound();
+
+				Optional<Set<BVar>> mfs = mfsGen.newMFS();
+
+				if (!mfs)
+					break;
+
+				/* Block the MFS itself, so that the solver moves on without waiting for its MSS */
+				mfsGen.blockMSS(*mfs);
+
+				while (!candidates.tryPush(*mfs) && !stop.load(std::memory_order_relaxed))
+				{
+					drainFound();
+					std::this_thread::yield();
+				}
+			}
+		}
+		catch (...)
+		{
+			producerError = std::current_exception();
+		}
+
+		producerDone.store(true, std::memory_order_release);
+	});
+
+	try
+	{
+		Set<BVar> mfs;
+
+		for (;;)
+		{
+			/* Must be read before the queue, so that an empty queue really means there is nothing left */
+			bool done = producerDone.load(std::memory_order_acquire);
+
+			if (candidates.tryPop(mfs))
+			{
+				/* Candidate was covered by an MSS found after it was queued */
+				if (model.alreadyCovered(componentId, mfs))
+					continue;
+
+				checkCancelled(options);
+				checkpointIfDue(model, options);
+
+				Set<BVar> mss = storeMSSCovering(componentId, mfs, mssGen, model, coverage);
+
+				while (!found.tryPush(mss) && !producerDone.load(std::memory_order_acquire))
+					std::this_thread::yield();
+			}
+			else if (done)
+			{
+				break;
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+	catch (...)
+	{
+		stop.store(true);
+		producer.join();
+		throw;
+	}
+
+	producer.join();
+
+	if (producerError)
+		std::rethrow_exception(producerError);
+}
+
+/**
+ * Version of the loop calling computeAndStoreNextMSS that switches between MFS-driven
+ * search and direct MSS enumeration, depending on the costs measured on the component.
+ *
+ * In MFS mode every entry costs a SAT call (new MFS) and a MaxSAT call (MSS covering it).
+ * When the SAT calls dominate by a margin, MSS are enumerated directly with
+ * MSSGenerator::newMSS instead. A direct MSS is only useful if it covers a falsifiable
+ * set not covered yet, which is checked afterwards with an MFS call restricted to the
+ * MSS (cheap, since everything outside the MSS is fixed); MSS that are not useful are
+ * dropped from the model. Direct mode is left when its cost per useful entry is not
+ * clearly below the cost of an entry in MFS mode (it is then retried after twice as
+ * many entries as before), or when there are no MSS left. The MFS generator always has
+ * the final word on whether everything is covered.
+ */
+void adaptiveMSSLoop(size_t componentId,
+		     MFSGenerator& mfsGen,
+		     MSSGenerator& mssGen,
+		     Model& model,
+		     const SynthesisOptions& options,
+		     CoverageWeights* coverage)
+{
+  using Clock = std::chrono::steady_clock;
+
+  const double smoothing = 0.3; /*< weight of the newest sample in the moving averages */
+  const size_t minimumDwell = 4; /*< entries computed in a mode before switching again */
+
+  /*
+   * Required advantage of the cheaper mode: an MSS built around an uncovered MFS tends to
+   * cover more new MFS than one enumerated directly, so equal costs favour MFS mode.
+   */
+  const double margin = 2;
+
+  /* Moving averages of the time per entry (in seconds) and of the fraction of useful direct MSS */
+  double mfsCost = 0;
+  double mssCost = 0;
+  double directCost = 0;
+  double usefulRate = 0;
+
+  auto secondsSince = [] (Clock::time_point start)
+  {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  };
+
+  /* The first sample after a switch replaces the (stale) average */
+  auto update = [smoothing] (double& average, double sample, bool first)
+  {
+    average = first ? sample : (1 - smoothing) * average + smoothing * sample;
+  };
+
+  const Set<BVar>& component = model.allComponents()[componentId];
+
+  bool direct = false;
+  bool exhausted = false; /*< direct enumeration ran out of MSS */
+  size_t dwell = 0; /*< entries computed since the last switch */
+  size_t retryDwell = minimumDwell; /*< entries computed in MFS mode before trying direct mode */
+
+  for (;;)
+  {
+    checkCancelled(options);
+    checkpointIfDue(model, options);
+
+    if (!direct)
+    {
+      auto start = Clock::now();
+      Optional<Set<BVar>> mfs = mfsGen.newMFS();
+      double mfsTime = secondsSince(start);
+
+      if (!mfs)
+        return;
+
+      start = Clock::now();
+      Set<BVar> mss = storeMSSCovering(componentId, *mfs, mssGen, model, coverage);
+      mfsGen.blockMSS(mss);
+      double mssTime = secondsSince(start);
+
+      update(mfsCost, mfsTime, dwell == 0);
+      update(mssCost, mssTime, dwell == 0);
+
+      if (++dwell >= retryDwell && !exhausted && mfsCost > margin * mssCost)
+      {
+        direct = true;
+        dwell = 0;
+      }
+    }
+    else
+    {
+      auto start = Clock::now();
+      Optional<Set<BVar>> mss = mssGen.newMSS();
+
+      if (!mss)
+      {
+        exhausted = true;
+        direct = false;
+        dwell = 0;
+        continue;
+      }
+
+      /* Useful iff some falsifiable set inside the MSS is not covered by the model yet */
+      bool useful = static_cast<bool>(mfsGen.newMFS(Set<BVar>(), setDifference(component, *mss)));
+
+      if (useful)
+      {
+        if (coverage)
+          coverage->recordMSS(*mss);
+
+        model.addMSS(componentId, *mss);
+        mfsGen.blockMSS(*mss);
+      }
+
+      update(directCost, secondsSince(start), dwell == 0);
+      update(usefulRate, useful ? 1 : 0, dwell == 0);
+
+      if (++dwell >= minimumDwell && margin * directCost > usefulRate * (mfsCost + mssCost))
+      {
+        direct = false;
+        dwell = 0;
+        retryDwell *= 2;
+      }
+    }
+  }
+}
+
+/**
+ * Computes MSS until every MFS of the component is covered, using the strategy selected in the options.
+ */
+void coverAllMFS(size_t componentId,
+		 MFSGenerator& mfsGen,
+		 MSSGenerator& mssGen,
+		 Model& model,
+		 const SynthesisOptions& options,
+		 CoverageWeights* coverage)
+{
+	if (options.pipeline)
+	{
+		pipelinedMSSLoop(componentId, mfsGen, mssGen, model, options, coverage);
+	}
+	else if (options.adaptive)
+	{
+		adaptiveMSSLoop(componentId, mfsGen, mssGen, model, options, coverage);
+	}
+	else
+	{
+		/* Repeat while there are still MSS to be computed */
+		while (computeAndStoreNextMSS(componentId, mfsGen, mssGen, model, coverage))
+		{
+			checkCancelled(options);
+			checkpointIfDue(model, options);
+		}
+	}
+}
+
+/**
+ * Returns the degree of every vertex of the conflict graph, in the order of its vertices.
+ */
+Vector<size_t> conflictDegrees(const Graph<size_t>& conflictGraph)
+{
+	Vector<size_t> degrees;
+
+	for (size_t i = 0; i < conflictGraph.size(); i++)
+		degrees.push_back(conflictGraph.degree(conflictGraph.vertexByIndex(i)));
+
+	return degrees;
+}
+
+Vector<Cube> splitIntoCubes(const Vector<BVar>& indicators,
+                            const Graph<size_t>& conflictGraph,
+                            size_t cubeVarCount)
+{
+	Vector<size_t> degrees = conflictDegrees(conflictGraph);
+
+	/* Order indicators by decreasing degree */
+	Vector<size_t> order(indicators.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(),
+	                 [&degrees] (size_t i, size_t j) { return degrees[i] > degrees[j]; });
+
+	order.resize(std::min(cubeVarCount, order.size()));
+
+	Vector<Cube> cubes;
+
+	for (size_t mask = 0; mask < (size_t(1) << order.size()); mask++)
+	{
+		Cube cube;
+		Vector<size_t> inVertices;
+		bool consistent = true;
+
+		for (size_t b = 0; b < order.size(); b++)
+		{
+			size_t i = order[b];
+
+			if ((mask >> b) & 1)
+			{
+				for (size_t j : inVertices)
+					if (conflictGraph.edgeExists(conflictGraph.vertexByIndex(i), conflictGraph.vertexByIndex(j)))
+						consistent = false;
+
+				inVertices.push_back(i);
+				cube.in.insert(indicators[i]);
+			}
+			else
+			{
+				cube.out.insert(indicators[i]);
+			}
+		}
+
+		if (consistent)
+			cubes.push_back(cube);
+	}
+
+	return cubes;
+}
+
+/**
+ * Covers all MFS of a single component using several worker threads.
+ *
+ * The MFS search space is split into cubes over high-degree indicators, and every
+ * worker takes cubes from a shared counter, running its own MFS and MSS generators
+ * on them. Every MSS found is broadcast through a shared list: before each SAT call
+ * a worker blocks the MSS found by the others, and an MFS covered by an MSS
+ * broadcast while it was being computed is dropped before the MaxSAT call.
+ *
+ * A cube is finished when its MFS solver has no MFS left, which means every MFS in
+ * the cube is covered by an MSS in the shared list. Since the cubes partition the
+ * search space, the shared list covers every MFS of the component when all cubes
+ * are finished.
+ */
+void cubeAndConquer(size_t componentId,
+                    const Set<BVar>& relevantIndicators,
+                    const Vector<BVar>& indicatorVars,
+                    const Vector<BVar>& subIndicatorVars,
+                    const Vector<CNFClause>& subOutputClauses,
+                    const Graph<size_t>& conflictSubgraph,
+                    Model& model,
+                    const SynthesisOptions& options)
+{
+	size_t workerCount = options.cubeWorkers;
+	size_t cubeVarCount = options.cubeVars;
+
+	/* By default, use a few more cubes than workers so that the load is balanced */
+	if (cubeVarCount == 0)
+	{
+		while ((size_t(1) << cubeVarCount) < workerCount)
+			cubeVarCount++;
+
+		cubeVarCount += 2;
+	}
+
+	Vector<Cube> cubes = splitIntoCubes(subIndicatorVars, conflictSubgraph, cubeVarCount);
+
+	std::mutex sharedMutex; /*< protects sharedMSS */
+	Vector<Set<BVar>> sharedMSS; /*< MSS found by all workers, in order */
+
+	std::atomic<size_t> nextCube(0);
+	std::atomic<bool> stop(false);
+	std::exception_ptr error;
+
+	auto worker = [&] ()
+	{
+		try
+		{
+			MFSGenerator mfsGen(relevantIndicators, indicatorVars, conflictSubgraph);
+			MSSGenerator mssGen(relevantIndicators, subIndicatorVars, subOutputClauses, options.structuredMSS, options.approximate,
+			                    options.maxsat);
+
+			Optional<CoverageWeights> coverage;
+
+			if (options.coverageWeights)
+				coverage.emplace(subIndicatorVars, conflictDegrees(conflictSubgraph), options.coverageWindow);
+
+			size_t imported = 0; /*< number of shared MSS already blocked by this worker */
+
+			/*
+			 * Blocks the shared MSS not seen yet, returning true if one of them covers the given set.
+			 * Must be called with sharedMutex locked.
+			 */
+			auto importShared = [&] (const Set<BVar>& s)
+			{
+				bool covered = false;
+
+				for (; imported < sharedMSS.size(); imported++)
+				{
+					mfsGen.blockMSS(sharedMSS[imported]);
+					covered = covered || isSubset(s, sharedMSS[imported]);
+				}
+
+				return covered;
+			};
+
+			for (size_t c = nextCube++; c < cubes.size() && !stop; c = nextCube++)
+			{
+				for (;;)
+				{
+					checkCancelled(options);
+
+					{
+						std::lock_guard<std::mutex> lock(sharedMutex);
+						importShared(Set<BVar>());
+					}
+
+					Optional<Set<BVar>> mfs = mfsGen.newMFS(cubes[c].in, cubes[c].out);
+
+					if (!mfs || stop)
+						break;
+
+					{
+						/* Covered by an MSS another worker found while this MFS was being computed */
+						std::lock_guard<std::mutex> lock(sharedMutex);
+
+						if (importShared(*mfs))
+							continue;
+					}
+
+					Optional<Set<BVar>> mss = coverage ?
+						mssGen.newMSSCovering(*mfs, coverage->weights()) :
+						mssGen.newMSSCovering(*mfs);
+
+					if (!mss)
+					{
+						/* This branch will never be reached if the specification is realizable */
+						throw Unrealizable();
+					}
+
+					if (coverage)
+						coverage->recordMSS(*mss);
+
+					std::lock_guard<std::mutex> lock(sharedMutex);
+
+					/*
+					 * Another worker may have covered the same MFS during the MaxSAT call.
+					 * Otherwise broadcast the MSS, it will be blocked by this worker on the next import.
+					 */
+					if (!importShared(*mfs))
+						sharedMSS.push_back(*mss);
+				}
+			}
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(sharedMutex);
+
+			if (!error)
+				error = std::current_exception();
+
+			stop = true;
+		}
+	};
+
+	Vector<std::thread> workers;
+
+	for (size_t i = 0; i < workerCount; i++)
+		workers.emplace_back(worker);
+
+	for (std::thread& t : workers)
+		t.join();
+
+	if (error)
+		std::rethrow_exception(error);
+
+	for (Set<BVar>& mss : sharedMSS)
+		model.addMSS(componentId, std::move(mss));
+}
+
+Vector<Set<BVar>> coverCube(const TrivialSpec& f1, const MSSSpec& f2, const Cube& cube,
+                            const Vector<Set<BVar>>& known, const SynthesisOptions& options)
+{
+	Graph<size_t> conflictGraph = f1.conflictGraph();
+
+	const Vector<BVar>& indicatorVars = f2.indicatorVars();
+	const Vector<CNFClause>& outputClauses = f2.outputCNF().clauses();
+
+	Set<BVar> allIndicatorVars(indicatorVars.begin(), indicatorVars.end());
+
+	MFSGenerator mfsGen(allIndicatorVars, indicatorVars, conflictGraph);
+	MSSGenerator mssGen(allIndicatorVars, indicatorVars, outputClauses, options.structuredMSS, options.approximate,
+	                    options.maxsat);
+
+	Optional<CoverageWeights> coverage;
+
+	if (options.coverageWeights)
+		coverage.emplace(indicatorVars, conflictDegrees(conflictGraph), options.coverageWindow);
+
+	/* The entries are collected in a single-component model, as in the other loops */
+	Model model;
+	size_t componentId = model.addComponent(allIndicatorVars);
+
+	for (const Set<BVar>& mss : known)
+		mfsGen.blockMSS(mss);
+
+	for (;;)
+	{
+		checkCancelled(options);
+
+		Optional<Set<BVar>> mfs = mfsGen.newMFS(cube.in, cube.out);
+
+		if (!mfs)
+			break;
+
+		Set<BVar> mss = storeMSSCovering(componentId, *mfs, mssGen, model, coverage ? &*coverage : nullptr);
+		mfsGen.blockMSS(mss);
+	}
+
+	return model.mssForComponent(componentId);
+}
+
+Model BAFAlgorithm(const TrivialSpec& f1, const MSSSpec& f2, const SynthesisOptions& options)
+{
+	/* Graph where every MIS corresponds to an MFS of F1 */
+	Graph<size_t> conflictGraph = f1.conflictGraph();
+
+	const Vector<BVar>& indicatorVars = f2.indicatorVars();
+	const Vector<CNFClause>& outputClauses = f2.outputCNF().clauses();
+
+	/* Set of all indicator variables */
+	Set<BVar> allIndicatorVars(indicatorVars.begin(), indicatorVars.end());
+
+	/* Initialize maximal-clique generator with graph and callback */
+	MFSGenerator mfsGen(allIndicatorVars, indicatorVars, conflictGraph);
+
+	/* Initialize MSS generator */
+	MSSGenerator mssGen(allIndicatorVars, indicatorVars, outputClauses, options.structuredMSS, options.approximate,
+	                    options.maxsat);
+    
+	/* Representation of the synthesized function */
+	Model model;
+
+	/* Since we are not decomposing specification into connected components,
+	 * there is a single component composed of all indicator variables.*/
+	size_t componentId = model.addComponent(allIndicatorVars);
+
+	Optional<CoverageWeights> coverage;
+
+	if (options.coverageWeights)
+		coverage.emplace(indicatorVars, conflictDegrees(conflictGraph), options.coverageWindow);
+
+	Set<size_t> allIndices;
+
+	for (size_t i = 0; i < indicatorVars.size(); i++)
+		allIndices.insert(i);
+
+	seedFromSimulation(componentId, allIndices, conflictGraph, indicatorVars,
+	                   Simulator(f1).simulateRounds(options.simulationRounds),
+	                   mfsGen, mssGen, model, coverage ? &*coverage : nullptr);
+
+	coverAllMFS(componentId, mfsGen, mssGen, model, options, coverage ? &*coverage : nullptr);
+
+#if MYDEBUG >=2     //printing the remaining of the mss
+	printf("No more mfs to cover, printing the remaining mss:\n");
+	Optional<Set<BVar>> mss;
+	mss = mssGen.newMSS();
+	while (mss) 
+	{
+		printf("Printing MSS:");
+		print(*mss, "z");
+		printf("\n");
+		mss = mssGen.newMSS();
+	}
+#endif
+  
+	printf("No more mss\n");
+
+	return model;
+}
+
+/**
+ * Solves a connected component of F2 with the first applicable method: enumeration for tiny
+ * components, input enumeration for narrow cones, cube-and-conquer for large components, and
+ * the back-and-forth loop otherwise. The list is stored in the model under componentId.
+ * The back-and-forth loop starts from the known entries, and from MSS grown from the seeds
+ * that cover an MFS not covered by the entries before them; both must be valid for the
+ * component. The other methods are complete on their own and ignore them. Returns true if the
+ * entries are exact MSS, false if they need not be maximal (approximate mode, input
+ * enumeration, or a seed that could not be grown).
+ */
+bool solveComponent(size_t componentId,
+                    const Set<size_t>& indices,
+                    const Set<BVar>& relevantIndicators,
+                    const Vector<BVar>& indicatorVars,
+                    const Vector<BVar>& subIndicatorVars,
+                    const Vector<CNFClause>& subOutputClauses,
+                    const Graph<size_t>& conflictSubgraph,
+                    const Simulator& simulator,
+                    const Vector<Vector<uint64_t>>& simulation,
+                    const Vector<Set<BVar>>& known,
+                    const Vector<Set<BVar>>& seeds,
+                    Model& model,
+                    const SynthesisOptions& options)
+{
+	/* Small components are solved by enumeration, without building any solver */
+	if (subIndicatorVars.size() <= options.tinyComponentSize)
+	{
+		for (Set<BVar>& mss : tinyComponentMSS(subIndicatorVars, subOutputClauses, conflictSubgraph))
+			model.addMSS(componentId, std::move(mss));
+
+		return true;
+	}
+
+	/* Components depending on few inputs are solved by enumerating the assignments to those inputs */
+	if (options.coneSize > 0)
+	{
+		Vector<size_t> definitions(indices.begin(), indices.end());
+
+		if (simulator.cone(definitions).size() <= options.coneSize)
+		{
+			for (Set<BVar>& entry : coneEnumerationEntries(simulator, definitions, subIndicatorVars, subOutputClauses))
+				model.addMSS(componentId, std::move(entry));
+
+			return false;
+		}
+	}
+
+	/* Large components are split into cubes solved in parallel */
+	if (options.cubeWorkers > 1 && subIndicatorVars.size() >= options.cubeMinIndicators)
+	{
+		cubeAndConquer(componentId, relevantIndicators, indicatorVars,
+		               subIndicatorVars, subOutputClauses, conflictSubgraph,
+		               model, options);
+		return !options.approximate;
+	}
+
+	/* Initialize maximal-clique generator with graph and callback */
+	MFSGenerator mfsGen(relevantIndicators, indicatorVars, conflictSubgraph);
+
+	/* Initialize MSS generator */
+	MSSGenerator mssGen(relevantIndicators, subIndicatorVars, subOutputClauses, options.structuredMSS, options.approximate,
+	                    options.maxsat);
+
+	Optional<CoverageWeights> coverage;
+
+	if (options.coverageWeights)
+		coverage.emplace(subIndicatorVars, conflictDegrees(conflictSubgraph), options.coverageWindow);
+
+	for (const Set<BVar>& entry : known)
+	{
+		mfsGen.blockMSS(entry);
+		model.addMSS(componentId, entry);
+	}
+
+	bool seeded = false;
+
+	/*
+	 * As in adaptiveMSSLoop, a seed is useful iff some MFS inside it is not covered yet. Its
+	 * indicators are then grown to an MSS, which covers every MFS the seed does and usually
+	 * more, so that the seeds after it are dropped as in a run from scratch.
+	 */
+	for (const Set<BVar>& seed : seeds)
+	{
+		if (!mfsGen.newMFS(Set<BVar>(), setDifference(relevantIndicators, seed)))
+			continue;
+
+		Optional<Set<BVar>> mss = mssGen.newMSSCovering(setIntersection(seed, relevantIndicators));
+
+		if (!mss)
+		{
+			mss = seed;
+			seeded = true;
+		}
+
+		if (coverage)
+			coverage->recordMSS(*mss);
+
+		mfsGen.blockMSS(*mss);
+		model.addMSS(componentId, *mss);
+	}
+
+	seedFromSimulation(componentId, indices, conflictSubgraph, indicatorVars, simulation,
+	                   mfsGen, mssGen, model, coverage ? &*coverage : nullptr);
+
+	coverAllMFS(componentId, mfsGen, mssGen, model, options, coverage ? &*coverage : nullptr);
+  
+#if MYDEBUG >=2    //printing the remaining of the mss
+	printf("No more mfs to cover, printing the remaining mss:\n");
+	Optional<Set<BVar>> mss;
+	mss = mssGen.newMSS();
+	while (mss) 
+	{
+		printf("Printing MSS:");
+		print(*mss, "z");
+		printf("\n");
+		mss = mssGen.newMSS();
+	}
+#endif
+
+	/* A seed that was not grown need not be MSS */
+	return !options.approximate && !seeded;
+}
+
+Model BAFConnectedComponents(const TrivialSpec& f1, const MSSSpec& f2, const SynthesisOptions& options)
+{
+	/* Graph where every MIS corresponds to an MFS of F1 */
+	Graph<size_t> conflictGraph = f1.conflictGraph();
+
+	const Vector<BVar>& indicatorVars = f2.indicatorVars();
+	const CNFFormula& outputCNF = f2.outputCNF();
+
+	/* Representation of the synthesized function */
+	Model model;
+
+	Vector<Set<size_t>> connectedComponents = outputCNF.dualGraph().connectedComponents();
+
+	Simulator simulator(f1);
+
+	/* Falsified sets of random and structured inputs, shared by all components */
+	Vector<Vector<uint64_t>> simulation = simulator.simulateRounds(options.simulationRounds);
+
+	/* Component solved first for every canonical form, with the form */
+	Map<std::string, std::pair<size_t, CanonicalComponent>> solvedForms;
+
+	/* Whether the list of the last component in the model is still being computed */
+	bool solving = false;
+
+	try
+	{
+		for (const Set<size_t>& indices : connectedComponents)
+		{
+			checkCancelled(options);
+
+			/* The lists of the components added so far are complete */
+			if (options.checkpoint)
+				options.checkpoint->update(model, true);
+
+#if MYDEBUG
+			// printf("Printing Connected Component:\n");   
+			//print(indices);
+#endif
+	      
+			/* Restrict indicator variables, output clauses and cliques graph to the indices in the connected component */
+			Vector<BVar> subIndicatorVars = subsequence(indicatorVars, indices);
+			Vector<CNFClause> subOutputClauses = subsequence(outputCNF.clauses(), indices);
+			Graph<size_t> conflictSubgraph = conflictGraph.subgraph(indices);
+	    
+#if MYDEBUG >=2  
+			printf("**************************************************************************************\n");
+			printf("Printing graph components:\n");
+			print(subIndicatorVars, "z");
+			printf("\n");
+			print(subOutputClauses, "y");
+#endif
+
+			/* Set of all indicator variables in the component */
+			Set<BVar> relevantIndicators(subIndicatorVars.begin(), subIndicatorVars.end());
+
+			/* Add connected component to model and get an identifier for it.
+			 * Identifier will be used to associate an MSS with this component. */
+			size_t componentId = model.addComponent(relevantIndicators);
+
+			/* Components completed before an interruption are restored */
+			if (options.checkpoint)
+			{
+				if (Optional<Vector<Set<BVar>>> restored = options.checkpoint->completedList(componentId, relevantIndicators))
+				{
+					for (Set<BVar>& entry : *restored)
+						model.addMSS(componentId, std::move(entry));
+
+					continue;
+				}
+			}
+
+			/* Components left unchanged by an edit keep their previous list */
+			if (options.previous)
+			{
+				if (Optional<Vector<Set<BVar>>> unchanged = options.previous->unchangedList(subIndicatorVars))
+				{
+					for (Set<BVar>& entry : *unchanged)
+						model.addMSS(componentId, std::move(entry));
+
+					continue;
+				}
+			}
+
+			/* Canonical form of the component, for isomorphism reuse and the cache */
+			Optional<CanonicalComponent> canon;
+
+			if ((options.reuseIsomorphic || options.cache) && subIndicatorVars.size() <= options.isomorphismLimit)
+				canon = canonicalComponent(subIndicatorVars, subOutputClauses, conflictSubgraph);
+
+			/* Components isomorphic to a solved one get its list, renamed */
+			if (canon && options.reuseIsomorphic)
+			{
+				auto solved = solvedForms.find(canon->key);
+
+				if (solved != solvedForms.end())
+				{
+					size_t sourceId = solved->second.first;
+					Map<BVar, BVar> renaming = componentRenaming(solved->second.second, *canon);
+
+					for (size_t j = 0; j < model.mssForComponent(sourceId).size(); j++)
+						model.addMSS(componentId, renameEntry(model.mssForComponent(sourceId)[j], renaming));
+
+					continue;
+				}
+
+				/* The list is filled from the cache or by solveComponent */
+				solvedForms.emplace(canon->key, std::make_pair(componentId, *canon));
+			}
+
+			/* Components solved by an earlier run are read back from the cache */
+			if (canon && options.cache)
+			{
+				if (Optional<Vector<Set<BVar>>> cached = options.cache->load(*canon, options.approximate || options.coneSize > 0))
+				{
+					for (Set<BVar>& entry : *cached)
+						model.addMSS(componentId, std::move(entry));
+
+					continue;
+				}
+			}
+
+			Vector<Set<BVar>> known;
+			Vector<Set<BVar>> seeds;
+
+			/* The generators of the component interrupted last resume from the entries it had */
+			if (options.checkpoint)
+				known = options.checkpoint->partialList(componentId, relevantIndicators);
+
+			/* Those entries already include the seeds kept by the interrupted run */
+			if (options.previous && known.empty())
+				seeds = options.previous->seeds(subIndicatorVars, subOutputClauses);
+
+			solving = true;
+
+			bool exact = solveComponent(componentId, indices, relevantIndicators, indicatorVars,
+			                            subIndicatorVars, subOutputClauses, conflictSubgraph,
+			                            simulator, simulation, known, seeds, model, options);
+
+			solving = false;
+
+			if (canon && options.cache)
+				options.cache->store(*canon, !exact, model.mssForComponent(componentId));
+		}
+	}
+	catch (const SynthesisCancelled&)
+	{
+		/* Keeps the entries found since the last checkpoint, without hiding the cancellation */
+		if (options.checkpoint)
+			options.checkpoint->trySave(model, !solving);
+
+		throw;
+	}
+
+	if (options.checkpoint)
+		options.checkpoint->save(model, true);
+
+	return model;
+}
+
+size_t nonMaximalCount(const Model& model, const MSSSpec& f2)
+{
+	const Vector<BVar>& indicatorVars = f2.indicatorVars();
+	const Vector<CNFClause>& outputClauses = f2.outputCNF().clauses();
+
+	Map<BVar, size_t> index;
+
+	for (size_t i = 0; i < indicatorVars.size(); i++)
+		index[indicatorVars[i]] = i;
+
+	size_t count = 0;
+
+	for (size_t c = 0; c < model.componentCount(); c++)
+	{
+		/* Components have disjoint output variables, so maximality is checked per component */
+		Vector<BVar> subIndicatorVars;
+		Vector<CNFClause> subOutputClauses;
+
+		for (BVar z : model.allComponents()[c])
+		{
+			subIndicatorVars.push_back(z);
+			subOutputClauses.push_back(outputClauses[index.at(z)]);
+		}
+
+		ApproximateMSS checker(subIndicatorVars, subOutputClauses);
+
+		for (const Set<BVar>& mss : model.mssForComponent(c))
+			if (!checker.isMaximal(setIntersection(mss, model.allComponents()[c])))
+				count++;
+	}
+
+	return count;
+}
+
+void minimizeModel(Model& model, const TrivialSpec& f1, const MSSSpec& f2, const SynthesisOptions& options)
+{
+	Graph<size_t> conflictGraph = f1.conflictGraph();
+
+	const Vector<BVar>& indicatorVars = f2.indicatorVars();
+
+	Map<BVar, size_t> index;
+
+	for (size_t i = 0; i < indicatorVars.size(); i++)
+		index[indicatorVars[i]] = i;
+
+	for (size_t c = 0; c < model.componentCount(); c++)
+	{
+		Set<size_t> indices;
+
+		for (BVar z : model.allComponents()[c])
+			indices.insert(index.at(z));
+
+		model.replaceMSSList(c, minimizeMSSList(model.mssForComponent(c), indicatorVars, conflictGraph.subgraph(indices),
+		                                        options.minimizeMFSLimit, options.minimizeExactSize));
+	}
+}
@@ -0,0 +1,182 @@
+#include "ApproximateMSS.hpp"
+
+#include <utility>
+
+using Glucose::vec;
+using Glucose::Lit;
+using Glucose::mkLit;
+using std::move;
+
+ApproximateMSS::ApproximateMSS(Vector<BVar> indicators, Vector<CNFClause> clauses)
+	: _indicators(move(indicators))
+	, _clauses(move(clauses))
+{
+	_satSolver.setIncrementalMode();
+
+	for (size_t i = 0; i < _clauses.size(); i++)
+	{
+		int z = _satSolver.newVar();
+		_indicatorVar[_indicators[i]] = z;
+
+		/* Prefer indicators set to true, so that the model already satisfies many clauses */
+		_satSolver.setPolarity(z, false);
+
+		/* Add clause (~z_i \/ Y_i) */
+		vec<Lit> lits;
+		lits.push(~mkLit(z));
+
+		for (BLit lit : _clauses[i])
+			lits.push((lit > 0) ? mkLit(outputVar(lit)) : ~mkLit(outputVar(-lit)));
+
+		_satSolver.addClause(lits);
+	}
+}
+
+int ApproximateMSS::outputVar(BVar var)
+{
+	auto it = _outputVar.find(var);
+
+	if (it != _outputVar.end())
+		return it->second;
+
+	int v = _satSolver.newVar();
+	_outputVar[var] = v;
+
+	return v;
+}
+
+Optional<Set<BVar>> ApproximateMSS::newSetCovering(const Set<BVar>& vars)
+{
+	vec<Lit> assumptions;
+
+	for (BVar var : vars)
+		assumptions.push(mkLit(_indicatorVar.at(var)));
+
+	if (!_satSolver.solve(assumptions))
+		return nullopt;
+
+	/* Current output assignment, local to this call */
+	Map<BVar, bool> value;
+
+	for (const auto& entry : _outputVar)
+		value[entry.first] = (_satSolver.model[entry.second] == l_True);
+
+	auto isTrueLit = [&value] (BLit lit) { return value.at(abs(lit)) == (lit > 0); };
+
+	/* trueCount[i] is the number of true literals of Y_i, included[i] is set if z_i is in the result */
+	Vector<size_t> trueCount(_clauses.size(), 0);
+	Vector<bool> included(_clauses.size(), false);
+	Map<BVar, Vector<std::pair<size_t, BLit>>> occurrences; /*< clauses containing a variable, with its literal */
+
+	for (size_t i = 0; i < _clauses.size(); i++)
+	{
+		for (BLit lit : _clauses[i])
+		{
+			occurrences[abs(lit)].emplace_back(i, lit);
+
+			if (isTrueLit(lit))
+				trueCount[i]++;
+		}
+
+		included[i] = (trueCount[i] > 0);
+	}
+
+	/*
+	 * Greedy growth: for every clause still falsified, flip one of its variables if that
+	 * does not falsify a clause already included (a "make without break" move).
+	 * Flips may enable further moves, so passes are repeated until none succeeds.
+	 */
+	for (bool grown = true; grown; )
+	{
+		grown = false;
+
+		for (size_t i = 0; i < _clauses.size(); i++)
+		{
+			if (included[i])
+				continue;
+
+			for (BLit lit : _clauses[i])
+			{
+				BVar var = abs(lit);
+
+				bool breaks = false;
+
+				for (const auto& occurrence : occurrences[var])
+				{
+					size_t j = occurrence.first;
+
+					if (included[j] && trueCount[j] == 1 && isTrueLit(occurrence.second))
+					{
+						breaks = true;
+						break;
+					}
+				}
+
+				if (breaks)
+					continue;
+
+				for (const auto& occurrence : occurrences[var])
+				{
+					size_t j = occurrence.first;
+
+					if (isTrueLit(occurrence.second))
+						trueCount[j]--;
+					else
+						trueCount[j]++;
+				}
+
+				value[var] = !value[var];
+
+				for (const auto& occurrence : occurrences[var])
+					if (trueCount[occurrence.first] > 0)
+						included[occurrence.first] = true;
+
+				grown = true;
+				break;
+			}
+		}
+	}
+
+	Set<BVar> result;
+
+	for (const auto& entry : value)
+		if (entry.second)
+			result.insert(entry.first);
+
+	for (size_t i = 0; i < _clauses.size(); i++)
+		if (included[i])
+			result.insert(_indicators[i]);
+
+	return result;
+}
+
+bool ApproximateMSS::isMaximal(const Set<BVar>& set)
+{
+	/* Temporary clause "some indicator outside the set", enabled by an activation literal */
+	Lit activation = mkLit(_satSolver.newVar());
+
+	vec<Lit> someNew;
+	someNew.push(~activation);
+
+	vec<Lit> assumptions;
+	assumptions.push(activation);
+
+	for (size_t i = 0; i < _indicators.size(); i++)
+	{
+		Lit z = mkLit(_indicatorVar.at(_indicators[i]));
+
+		if (set.find(_indicators[i]) == set.end())
+			someNew.push(z);
+		else
+			assumptions.push(z);
+	}
+
+	_satSolver.addClause(someNew);
+
+	bool extensible = _satSolver.solve(assumptions);
+
+	/* Disable the temporary clause permanently */
+	_satSolver.addClause(~activation);
+
+	return !extensible;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CNFFormula.hpp"
+#include "Set.hpp"
+#include "Map.hpp"
+#include "Vector.hpp"
+#include "Optional.hpp"
+#include "open-wbo/solvers/glucose4.1/core/Solver.h"
+
+/**
+ * Computes satisfiable (but not necessarily maximal) subsets with a single SAT call.
+ *
+ * The clauses (z_i -> Y_i) are loaded once into an incremental SAT solver whose
+ * decision heuristic prefers setting indicators to true. A set containing the given
+ * indicators is obtained by solving under assumptions and then growing it greedily:
+ * every clause Y_i still falsified by the output part of the model is made true by
+ * flipping one of its variables, when this falsifies no clause already chosen. The result is a
+ * valid decision-list entry, but since no indicator is ever retried it may be
+ * subsumed by a later entry, making the list longer than with exact MSS.
+ */
+class ApproximateMSS
+{
+	Vector<BVar> _indicators; /*< z_1, ..., z_n */
+	Vector<CNFClause> _clauses; /*< Y_1, ..., Y_n */
+	Map<BVar, int> _outputVar; /*< variable of the SAT solver representing a y variable */
+	Map<BVar, int> _indicatorVar; /*< variable of the SAT solver representing a z variable */
+
+	Glucose::Solver _satSolver; /*< incremental solver holding the clauses (z_i -> Y_i) */
+
+	/** Returns the solver variable representing output variable var, creating it if needed */
+	int outputVar(BVar var);
+
+public:
+
+	/** Constructs an engine for the clauses (z_i -> Y_i), where z_i = indicators[i] and Y_i = clauses[i] */
+	ApproximateMSS(Vector<BVar> indicators, Vector<CNFClause> clauses);
+
+	/**
+	 * Generate a satisfiable set containing the given indicators, or nothing if they are not satisfiable.
+	 * The set is represented by the set of Z and Y variables set to true.
+	 */
+	Optional<Set<BVar>> newSetCovering(const Set<BVar>& vars);
+
+	/** Checks (with one SAT call) that no indicator outside the given satisfiable set can be added to it */
+	bool isMaximal(const Set<BVar>& set);
+};
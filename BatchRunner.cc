@@ -0,0 +1,410 @@
+#include "BatchRunner.hpp"
+#include "ReadInput.hpp"
+#include "Synthesis.hpp"
+#include "ModelFile.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#include <malloc.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using std::string;
+using std::runtime_error;
+using std::chrono::milliseconds;
+using std::chrono::duration_cast;
+
+namespace
+{
+	/** Poll interval of the watchdog */
+	const milliseconds watchdogPeriod(10);
+
+	const char* statusName(JobResult::Status status)
+	{
+		switch (status)
+		{
+		case JobResult::Done: return "done";
+		case JobResult::Unrealizable: return "unrealizable";
+		case JobResult::Timeout: return "timeout";
+		case JobResult::Memout: return "memout";
+		default: return "error";
+		}
+	}
+
+	/** Resident memory of the process in bytes */
+	size_t residentMemory()
+	{
+		std::ifstream statm("/proc/self/statm");
+		size_t size = 0, resident = 0;
+
+		statm >> size >> resident;
+
+		return resident * size_t(sysconf(_SC_PAGESIZE));
+	}
+
+	/** The line without leading and trailing white space (including the '\r' of CRLF files) */
+	string trim(const string& line)
+	{
+		const char* space = " \t\r\n";
+		size_t first = line.find_first_not_of(space);
+
+		if (first == string::npos)
+			return string();
+
+		return line.substr(first, line.find_last_not_of(space) - first + 1);
+	}
+
+	/** Whether the line names a job, as opposed to an empty line or a comment */
+	bool isJob(const string& path)
+	{
+		return !path.empty() && path[0] != '#';
+	}
+
+	/** Client of serveBatch; the serving thread keeps it alive until all its jobs have reported */
+	struct Connection
+	{
+		int fd;
+		std::mutex mutex;
+		std::condition_variable idle; /*< signalled when the last pending job reports */
+		size_t pending = 0;
+		bool broken = false; /*< the client went away, results are dropped */
+
+		explicit Connection(int fd) : fd(fd) {}
+
+		~Connection()
+		{
+			close(fd);
+		}
+
+		void send(const string& line)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			for (size_t sent = 0; sent < line.size() && !broken;)
+			{
+				ssize_t n = ::send(fd, line.data() + sent, line.size() - sent, MSG_NOSIGNAL);
+
+				if (n >= 0)
+					sent += n;
+				else if (errno != EINTR)
+					broken = true;
+			}
+		}
+	};
+
+	void serveClient(BatchRunner& runner, int fd)
+	{
+		Connection connection(fd);
+
+		auto submit = [&] (const string& line)
+		{
+			string path = trim(line);
+
+			if (!isJob(path))
+				return;
+
+			{
+				std::lock_guard<std::mutex> lock(connection.mutex);
+				connection.pending++;
+			}
+
+			runner.submit(path, [&connection] (const JobResult& result)
+			{
+				connection.send(result.format() + "\n");
+
+				std::lock_guard<std::mutex> lock(connection.mutex);
+
+				if (--connection.pending == 0)
+					connection.idle.notify_all();
+			});
+		};
+
+		string buffer;
+		char chunk[4096];
+
+		for (;;)
+		{
+			ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+
+			if (n < 0 && errno == EINTR)
+				continue;
+			if (n <= 0)
+				break;
+
+			buffer.append(chunk, n);
+
+			size_t newline;
+
+			while ((newline = buffer.find('\n')) != string::npos)
+			{
+				submit(buffer.substr(0, newline));
+				buffer.erase(0, newline + 1);
+			}
+		}
+
+		submit(buffer); /*< last line without a newline */
+
+		std::unique_lock<std::mutex> lock(connection.mutex);
+		connection.idle.wait(lock, [&] { return connection.pending == 0; });
+	}
+}
+
+string JobResult::format() const
+{
+	string line = string(statusName(status)) + "\t" + std::to_string(entries) + "\t" +
+		std::to_string(time) + "\t" + path;
+
+	if (!message.empty())
+		line += "\t" + message;
+
+	return line;
+}
+
+BatchRunner::BatchRunner(const SynthesisOptions& synthesis, const BatchOptions& batch)
+	: _synthesis(synthesis), _batch(batch)
+{
+	size_t threads = (batch.threads > 0) ? batch.threads : std::max(1u, std::thread::hardware_concurrency());
+
+	for (size_t t = 0; t < threads; t++)
+		_slots.emplace_back(new Slot());
+
+	for (size_t t = 0; t < threads; t++)
+		_workers.emplace_back(&BatchRunner::work, this, std::ref(*_slots[t]));
+
+	if (batch.timeout > 0 || batch.memoryLimit > 0)
+		_watchdog = std::thread(&BatchRunner::watch, this);
+}
+
+BatchRunner::~BatchRunner()
+{
+	finish();
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+
+	_jobReady.notify_all();
+	_jobDone.notify_all();
+
+	for (std::thread& worker : _workers)
+		worker.join();
+
+	if (_watchdog.joinable())
+		_watchdog.join();
+}
+
+void BatchRunner::submit(const string& path, Report report)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_queue.push_back(Job { path, std::move(report) });
+		_pending++;
+	}
+
+	_jobReady.notify_one();
+}
+
+void BatchRunner::finish()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_jobDone.wait(lock, [this] { return _pending == 0; });
+}
+
+void BatchRunner::work(Slot& slot)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	for (;;)
+	{
+		_jobReady.wait(lock, [this] { return _stopping || !_queue.empty(); });
+
+		if (_queue.empty())
+			return;
+
+		Job job = std::move(_queue.front());
+		_queue.pop_front();
+
+		slot.busy = true;
+		slot.start = Clock::now();
+		slot.reason = JobResult::Error;
+		slot.cancel.store(false);
+
+		lock.unlock();
+
+		JobResult result = run(job.path, slot);
+
+		/* Give the memory of a cancelled job back to the system, so that the watchdog sees it go */
+		if (slot.cancel.load())
+			malloc_trim(0);
+
+		job.report(result);
+
+		lock.lock();
+
+		slot.busy = false;
+		_pending--;
+		_jobDone.notify_all();
+	}
+}
+
+JobResult BatchRunner::run(const string& path, Slot& slot)
+{
+	JobResult result;
+	result.path = path;
+
+	try
+	{
+		SynthesisOptions options = _synthesis;
+		options.cancel = &slot.cancel;
+
+		CNFSpec spec = loadDIMACS(path);
+		Synthesis synthesis = synthesize(spec, options, _batch.minimize);
+
+		result.entries = synthesis.model.mssCount();
+
+		if (!_batch.modelDir.empty())
+		{
+			string name = path.substr(path.find_last_of('/') + 1);
+			saveModel(_batch.modelDir + "/" + name + ".model", synthesis.model, synthesis.chain.first, spec);
+		}
+
+		result.status = JobResult::Done;
+	}
+	catch (const SynthesisCancelled&)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		result.status = slot.reason;
+	}
+	catch (const Unrealizable&)
+	{
+		result.status = JobResult::Unrealizable;
+	}
+	catch (const std::exception& e)
+	{
+		result.message = e.what();
+	}
+
+	result.time = duration_cast<milliseconds>(Clock::now() - slot.start).count();
+
+	return result;
+}
+
+void BatchRunner::watch()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	while (!_stopping)
+	{
+		_jobDone.wait_for(lock, watchdogPeriod);
+
+		Clock::time_point now = Clock::now();
+		Slot* oldest = nullptr;
+		size_t running = 0;
+		bool releasing = false; /*< some cancelled job has not finished yet */
+
+		auto cancel = [] (Slot& slot, JobResult::Status reason)
+		{
+			slot.reason = reason;
+			slot.cancel.store(true);
+		};
+
+		for (const std::unique_ptr<Slot>& slot : _slots)
+		{
+			if (!slot->busy)
+				continue;
+
+			if (slot->cancel.load())
+			{
+				releasing = true;
+				continue;
+			}
+
+			if (_batch.timeout > 0 && now - slot->start >= milliseconds(_batch.timeout))
+			{
+				cancel(*slot, JobResult::Timeout);
+				releasing = true;
+				continue;
+			}
+
+			running++;
+
+			if (!oldest || slot->start < oldest->start)
+				oldest = slot.get();
+		}
+
+		/* Cancelled jobs are given time to release their memory before another one is cancelled */
+		if (_batch.memoryLimit > 0 && oldest && !releasing &&
+		    residentMemory() > (_batch.memoryLimit << 20) * running)
+			cancel(*oldest, JobResult::Memout);
+	}
+}
+
+void runBatch(BatchRunner& runner, std::istream& jobs, std::ostream& results)
+{
+	std::mutex resultsMutex;
+	string line;
+
+	while (std::getline(jobs, line))
+	{
+		string path = trim(line);
+
+		if (!isJob(path))
+			continue;
+
+		runner.submit(path, [&] (const JobResult& result)
+		{
+			std::lock_guard<std::mutex> lock(resultsMutex);
+			results << result.format() << std::endl;
+		});
+	}
+
+	runner.finish();
+}
+
+void serveBatch(BatchRunner& runner, const string& path)
+{
+	sockaddr_un address;
+	std::memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+
+	if (path.size() >= sizeof(address.sun_path))
+		throw runtime_error("Socket path too long: " + path);
+
+	std::strcpy(address.sun_path, path.c_str());
+
+	int server = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	if (server < 0)
+		throw runtime_error("Could not create a socket");
+
+	unlink(path.c_str());
+
+	if (bind(server, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0 ||
+	    listen(server, SOMAXCONN) < 0)
+	{
+		close(server);
+		throw runtime_error("Could not listen on " + path);
+	}
+
+	for (;;)
+	{
+		int client = accept(server, nullptr, nullptr);
+
+		if (client < 0)
+		{
+			if (errno == EINTR || errno == ECONNABORTED)
+				continue;
+
+			close(server);
+			throw runtime_error("Could not accept connections on " + path);
+		}
+
+		std::thread(serveClient, std::ref(runner), client).detach();
+	}
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "SynthesisOptions.hpp"
+#include "Vector.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+/** Outcome of the synthesis of one specification of a batch */
+struct JobResult
+{
+	enum Status { Done, Unrealizable, Timeout, Memout, Error };
+
+	std::string path;
+	Status status = Error;
+	size_t entries = 0; /*< length of the decision list, if done */
+	long long time = 0; /*< wall-clock time of the job in ms, loading included */
+	std::string message; /*< reason of an error */
+
+	/** One line, tab-separated: status, entries, time in ms, path and the message of an error */
+	std::string format() const;
+};
+
+/** Parameters of a batch, on top of the synthesis options shared by all its jobs */
+struct BatchOptions
+{
+	size_t threads = 0; /*< number of jobs run at the same time (0 = one per core) */
+	long long timeout = 0; /*< time limit per job in ms (0 = none) */
+	size_t memoryLimit = 0; /*< resident memory limit per running job in MB (0 = none) */
+	bool minimize = false; /*< minimize every decision list after synthesis */
+	std::string modelDir; /*< if not empty, the model of every job is saved to <modelDir>/<file name>.model */
+};
+
+/**
+ * Runs synthesis jobs on a fixed pool of threads, so that many small specifications do not
+ * each pay for a process start.
+ *
+ * Every job loads a QDIMACS file and synthesizes it with its own solvers (see synthesize).
+ * A watchdog thread enforces the limits by cancelling jobs through SynthesisOptions::cancel:
+ * a job is cancelled when it exceeds the time limit, and when the resident memory of the
+ * process exceeds the memory limit times the number of running jobs, the longest-running
+ * job is cancelled. The memory of threads in one process cannot be told apart, so the
+ * memory limit is a budget shared by the running jobs rather than a cap on each of them.
+ * Cancellation takes effect before the next entry of the decision list, so a job may
+ * overrun its limits by the time of one SAT or MaxSAT call.
+ */
+class BatchRunner
+{
+	using Clock = std::chrono::steady_clock;
+	using Report = std::function<void(const JobResult&)>;
+
+	struct Job
+	{
+		std::string path;
+		Report report;
+	};
+
+	/** Job being run by a worker, guarded by _mutex except for the flag */
+	struct Slot
+	{
+		bool busy = false;
+		Clock::time_point start;
+		JobResult::Status reason = JobResult::Error; /*< why the job was cancelled */
+		std::atomic<bool> cancel { false };
+	};
+
+	SynthesisOptions _synthesis;
+	BatchOptions _batch;
+
+	std::mutex _mutex;
+	std::condition_variable _jobReady; /*< signalled when a job is queued or the pool stops */
+	std::condition_variable _jobDone; /*< signalled when a job finishes or the pool stops */
+	std::deque<Job> _queue;
+	size_t _pending = 0; /*< queued and running jobs */
+	bool _stopping = false;
+
+	Vector<std::unique_ptr<Slot>> _slots; /*< one per worker */
+	Vector<std::thread> _workers;
+	std::thread _watchdog;
+
+	void work(Slot& slot);
+	void watch();
+	JobResult run(const std::string& path, Slot& slot);
+
+public:
+
+	BatchRunner(const SynthesisOptions& synthesis, const BatchOptions& batch);
+
+	/** Waits for the queued jobs, then stops the threads */
+	~BatchRunner();
+
+	BatchRunner(const BatchRunner&) = delete;
+	BatchRunner& operator=(const BatchRunner&) = delete;
+
+	/**
+	 * Queues the specification at path. report is called with the result from the worker
+	 * thread that ran the job, as soon as the job finishes. May be called from any thread.
+	 */
+	void submit(const std::string& path, Report report);
+
+	/** Waits until every job submitted so far has finished */
+	void finish();
+};
+
+/**
+ * Runs the specifications listed in jobs, one path per line (empty lines and lines starting
+ * with '#' are skipped), and writes the result of every job to results as soon as it finishes,
+ * so results are in completion order. Returns once all listed jobs have finished.
+ */
+void runBatch(BatchRunner& runner, std::istream& jobs, std::ostream& results);
+
+/**
+ * Listens on a Unix-domain stream socket at path and serves clients until an error occurs:
+ * every client sends paths as in runBatch and receives the result lines of its own jobs,
+ * in completion order. The connection is closed once the client has shut down its side
+ * and all its jobs have finished. An existing socket file at path is replaced.
+ */
+void serveBatch(BatchRunner& runner, const std::string& path);
@@ -0,0 +1,268 @@
+#include "Checkpoint.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using std::string;
+using std::runtime_error;
+
+namespace
+{
+	const char checkpointMagic[] = "bafsyn-checkpoint";
+	const int checkpointVersion = 1;
+
+	/** FNV-1a over the inputs, the outputs and the clauses of the specification, with 0 between lists */
+	uint64_t specFingerprint(const CNFSpec& spec)
+	{
+		uint64_t hash = 0xcbf29ce484222325;
+
+		auto add = [&hash] (int32_t value)
+		{
+			for (int b = 0; b < 4; b++)
+				hash = (hash ^ ((uint32_t(value) >> (8 * b)) & 0xff)) * 0x100000001b3;
+		};
+
+		for (BVar x : spec.inputVars())
+			add(x);
+
+		add(0);
+
+		for (BVar y : spec.outputVars())
+			add(y);
+
+		add(0);
+
+		for (const CNFClause& clause : spec.cnf().clauses())
+		{
+			for (BLit lit : clause)
+				add(lit);
+
+			add(0);
+		}
+
+		return hash;
+	}
+
+	void writeList(std::ostream& out, const Set<BVar>& vars)
+	{
+		for (BVar var : vars)
+			out << var << ' ';
+
+		out << "0\n";
+	}
+
+	/** Flushes the file or directory at the path to the disk */
+	bool syncPath(const string& path)
+	{
+		int fd = ::open(path.c_str(), O_RDONLY);
+
+		if (fd < 0)
+			return false;
+
+		bool synced = (fsync(fd) == 0);
+		::close(fd);
+
+		return synced;
+	}
+
+	/** Directory holding the file at the path */
+	string directoryOf(const string& path)
+	{
+		size_t slash = path.rfind('/');
+
+		if (slash == string::npos)
+			return ".";
+
+		return (slash == 0) ? "/" : path.substr(0, slash);
+	}
+
+	/** Reads variables up to the terminating 0 */
+	bool readList(std::istream& in, Set<BVar>& vars)
+	{
+		BVar var;
+
+		while (in >> var)
+		{
+			if (var == 0)
+				return true;
+
+			vars.insert(var);
+		}
+
+		return false;
+	}
+}
+
+Checkpoint::Checkpoint(const string& path, const CNFSpec& spec, long long interval)
+	: _path(path), _fingerprint(specFingerprint(spec)), _interval(interval), _lastWrite(Clock::now())
+{
+}
+
+bool Checkpoint::restore()
+{
+	std::ifstream in(_path);
+
+	if (!in)
+		return false;
+
+	string magic;
+	int version;
+	uint64_t fingerprint;
+
+	if (!(in >> magic >> version >> std::hex >> fingerprint >> std::dec) || magic != checkpointMagic)
+		throw runtime_error(_path + " is not a checkpoint");
+	if (version != checkpointVersion)
+		throw runtime_error(_path + ": unsupported version " + std::to_string(version));
+	if (fingerprint != _fingerprint)
+		throw runtime_error(_path + " was written for another specification");
+
+	string tag;
+
+	while (in >> tag)
+	{
+		int complete;
+		size_t count;
+		Set<BVar> indicators;
+
+		if (tag != "component" || !(in >> complete >> count) || !readList(in, indicators))
+			throw runtime_error(_path + ": damaged component " + std::to_string(_components.size()));
+
+		Vector<Set<BVar>> list(count);
+
+		for (Set<BVar>& entry : list)
+			if (!readList(in, entry))
+				throw runtime_error(_path + ": damaged component " + std::to_string(_components.size()));
+
+		_components.push_back(std::move(indicators));
+		_lists.push_back(std::move(list));
+		_complete.push_back(complete != 0);
+	}
+
+	return true;
+}
+
+size_t Checkpoint::restoredCount() const
+{
+	size_t count = 0;
+
+	for (bool complete : _complete)
+		count += complete ? 1 : 0;
+
+	return count;
+}
+
+const Vector<Set<BVar>>* Checkpoint::restored(size_t componentId, const Set<BVar>& indicators) const
+{
+	if (componentId >= _components.size())
+		return nullptr;
+
+	if (_components[componentId] != indicators)
+		throw runtime_error(_path + ": component " + std::to_string(componentId) + " does not match the specification");
+
+	return &_lists[componentId];
+}
+
+Optional<Vector<Set<BVar>>> Checkpoint::completedList(size_t componentId, const Set<BVar>& indicators) const
+{
+	const Vector<Set<BVar>>* list = restored(componentId, indicators);
+
+	if (!list || !_complete[componentId])
+		return nullopt;
+
+	return *list;
+}
+
+Vector<Set<BVar>> Checkpoint::partialList(size_t componentId, const Set<BVar>& indicators) const
+{
+	const Vector<Set<BVar>>* list = restored(componentId, indicators);
+
+	if (!list || _complete[componentId])
+		return Vector<Set<BVar>>();
+
+	return *list;
+}
+
+void Checkpoint::update(const Model& model, bool lastComplete)
+{
+	if (Clock::now() - _lastWrite >= _interval)
+		trySave(model, lastComplete);
+}
+
+void Checkpoint::trySave(const Model& model, bool lastComplete)
+{
+	try
+	{
+		save(model, lastComplete);
+		_failing = false;
+	}
+	catch (const runtime_error& e)
+	{
+		/* Synthesis goes on without checkpoints, and the next call tries again */
+		if (!_failing)
+			std::cerr << "Warning: " << e.what() << ", synthesis continues" << std::endl;
+
+		_failing = true;
+		_failedWriteCount++;
+	}
+}
+
+void Checkpoint::save(const Model& model, bool lastComplete)
+{
+	string temporary = _path + ".tmp." + std::to_string(getpid());
+
+	{
+		std::ofstream out(temporary, std::ios::trunc);
+
+		out << checkpointMagic << ' ' << checkpointVersion << ' ' << std::hex << _fingerprint << std::dec << '\n';
+
+		for (size_t c = 0; c < model.componentCount(); c++)
+		{
+			bool complete = lastComplete || c + 1 < model.componentCount();
+			const Vector<Set<BVar>>& entries = model.mssForComponent(c);
+
+			out << "component " << (complete ? 1 : 0) << ' ' << entries.size() << ' ';
+			writeList(out, model.allComponents()[c]);
+
+			for (const Set<BVar>& entry : entries)
+				writeList(out, entry);
+		}
+
+		out.close();
+
+		if (!out || !syncPath(temporary))
+		{
+			std::remove(temporary.c_str());
+			throw runtime_error("Could not write " + temporary);
+		}
+	}
+
+	if (std::rename(temporary.c_str(), _path.c_str()) != 0)
+	{
+		std::remove(temporary.c_str());
+		throw runtime_error("Could not write " + _path);
+	}
+
+	/*
+	 * The rename only survives a crash once the directory is on disk. Some file systems cannot
+	 * sync a directory, which is not an error: the new checkpoint is in place either way.
+	 */
+	syncPath(directoryOf(_path));
+
+	_lastWrite = Clock::now();
+	_writeCount++;
+}
+
+size_t Checkpoint::writeCount() const
+{
+	return _writeCount;
+}
+
+size_t Checkpoint::failedWriteCount() const
+{
+	return _failedWriteCount;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "CNFSpec.hpp"
+#include "Model.hpp"
+#include "Optional.hpp"
+#include "Set.hpp"
+#include "Vector.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Periodic snapshot of a run of BAFConnectedComponents, from which an interrupted run resumes.
+ *
+ * The state of the generators of a component is determined by the entries found so far, which
+ * are the blocking clauses of the MFS generator, so a checkpoint holds the lists of the
+ * components synthesized so far: complete lists for all of them but the last, and the entries
+ * found so far for the last one. A resumed run takes the complete lists as they are, and starts
+ * the loop of the last component with its entries blocked. Components are identified by their
+ * position in the decomposition, which is checked with a fingerprint of the specification.
+ *
+ * The file is text, with variables numbered as in the specification and lists ending with 0:
+ *
+ *     bafsyn-checkpoint 1 <fingerprint>
+ *     component <complete> <m> <indicators> 0            (one per component, in order)
+ *     <true z and y variables of an entry> 0             (m lines)
+ *
+ * It is written to a temporary file, flushed to disk and renamed, so an interruption or a
+ * crash during a write leaves the previous checkpoint.
+ */
+class Checkpoint
+{
+	using Clock = std::chrono::steady_clock;
+
+	std::string _path;
+	uint64_t _fingerprint;
+	std::chrono::milliseconds _interval;
+	Clock::time_point _lastWrite;
+	size_t _writeCount = 0;
+	size_t _failedWriteCount = 0;
+	bool _failing = false; /*< whether the last write failed, so that a lasting failure is reported once */
+
+	/* State read by restore */
+	Vector<Set<BVar>> _components;
+	Vector<Vector<Set<BVar>>> _lists;
+	Vector<bool> _complete;
+
+	/** The restored list of the component, if it has the given indicators */
+	const Vector<Set<BVar>>* restored(size_t componentId, const Set<BVar>& indicators) const;
+
+public:
+
+	/** Checkpoints of the synthesis of spec, written to path every interval ms at most */
+	Checkpoint(const std::string& path, const CNFSpec& spec, long long interval);
+
+	Checkpoint(const Checkpoint&) = delete;
+	Checkpoint& operator=(const Checkpoint&) = delete;
+
+	/**
+	 * Reads the checkpoint at the path. Returns false if there is none, and throws
+	 * std::runtime_error if it is damaged or was written for another specification.
+	 */
+	bool restore();
+
+	/** Number of components whose list was restored complete */
+	size_t restoredCount() const;
+
+	/** Restored list of the component, if it was complete (indicators are checked against the checkpoint) */
+	Optional<Vector<Set<BVar>>> completedList(size_t componentId, const Set<BVar>& indicators) const;
+
+	/** Restored entries of the component if its list was not complete, or nothing */
+	Vector<Set<BVar>> partialList(size_t componentId, const Set<BVar>& indicators) const;
+
+	/**
+	 * Writes the model if the interval has elapsed since the last successful write. The lists
+	 * of all components but the last are complete; lastComplete tells whether the last one is
+	 * too. A failed write does not stop synthesis (see trySave) and is retried at the next call.
+	 */
+	void update(const Model& model, bool lastComplete);
+
+	/** Writes the model now (see update), and throws std::runtime_error if it cannot */
+	void save(const Model& model, bool lastComplete);
+
+	/** Same as save, but a failed write is counted and reported on std::cerr instead of thrown */
+	void trySave(const Model& model, bool lastComplete);
+
+	size_t writeCount() const;
+	size_t failedWriteCount() const;
+};
@@ -0,0 +1,393 @@
+#include "CodeGenerator.hpp"
+#include "Map.hpp"
+#include "Vector.hpp"
+#include "Set.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+using std::ostream;
+using std::ostringstream;
+using std::string;
+using std::to_string;
+
+namespace
+{
+	/** Component prepared for generation */
+	struct ComponentCode
+	{
+		Vector<Vector<int>> definitions; /*< X_i of bit d, over input positions, literal +(k + 1) or -(k + 1) */
+		Vector<Vector<uint64_t>> masks; /*< indicators of every entry, in words of 64 bits */
+		Vector<Vector<size_t>> outputs; /*< positions of the outputs set to true by every entry */
+	};
+
+	/** Number of 64-bit words of a mask over the given number of bits, at least one */
+	size_t wordCount(size_t bits)
+	{
+		return std::max<size_t>((bits + 63) / 64, 1);
+	}
+
+	/** Smallest unsigned type holding the given number of bits, uint64_t beyond 64 */
+	string maskType(size_t bits)
+	{
+		if (bits <= 8)
+			return "uint8_t";
+		if (bits <= 16)
+			return "uint16_t";
+		if (bits <= 32)
+			return "uint32_t";
+
+		return "uint64_t";
+	}
+
+	string hexLiteral(uint64_t value)
+	{
+		ostringstream s;
+		s << "0x" << std::hex << value << ((value > UINT32_MAX) ? "ull" : "u");
+		return s.str();
+	}
+
+	/** Expression for ~X over scalar or word inputs: true iff every literal of X is false */
+	string negatedClause(const Vector<int>& clause, bool word)
+	{
+		string lits;
+
+		for (int lit : clause)
+		{
+			string x = "x[" + to_string(abs(lit) - 1) + "]";
+
+			if (!lits.empty())
+				lits += " | ";
+
+			lits += (lit > 0) ? x : (word ? "~" : "(!") + x + (word ? "" : ")");
+		}
+
+		if (lits.empty())
+			return word ? "~(uint64_t)0" : "1";
+
+		return (word ? "~(" : "!(") + lits + ")";
+	}
+
+	/** Constant table with the masks of the entries of a scalar component */
+	void writeMaskTable(ostream& out, const ComponentCode& code, size_t c)
+	{
+		size_t bits = code.definitions.size();
+		size_t words = wordCount(bits);
+
+		if (code.masks.empty())
+			return;
+
+		out << "static const " << maskType(bits) << " bafsyn_c" << c << "_masks[" << code.masks.size() << "]";
+
+		if (words > 1)
+			out << "[" << words << "]";
+
+		out << " =\n{\n";
+
+		for (const Vector<uint64_t>& mask : code.masks)
+		{
+			out << "\t";
+
+			if (words > 1)
+				out << "{ ";
+
+			for (size_t w = 0; w < words; w++)
+				out << ((w > 0) ? ", " : "") << hexLiteral(mask[w]);
+
+			if (words > 1)
+				out << " }";
+
+			out << ",\n";
+		}
+
+		out << "};\n\n";
+	}
+
+	/** Output stores of every entry, as a switch on the position j of the entry */
+	void writeStores(ostream& out, const ComponentCode& code, const string& indent)
+	{
+		bool anyStore = false;
+
+		for (const Vector<size_t>& outputs : code.outputs)
+			anyStore |= !outputs.empty();
+
+		if (!anyStore)
+			return;
+
+		out << indent << "switch (j)\n";
+		out << indent << "{\n";
+
+		for (size_t j = 0; j < code.outputs.size(); j++)
+		{
+			if (code.outputs[j].empty())
+				continue;
+
+			out << indent << "case " << j << ":";
+
+			for (size_t k : code.outputs[j])
+				out << " y[" << k << "] = 1;";
+
+			out << " break;\n";
+		}
+
+		out << indent << "}\n";
+	}
+
+	void writeScalarComponent(ostream& out, const ComponentCode& code, size_t c)
+	{
+		size_t bits = code.definitions.size();
+		size_t words = wordCount(bits);
+		string type = maskType(bits);
+		string table = "bafsyn_c" + to_string(c) + "_masks";
+
+		out << "\t/* Component " << c << ": " << bits << " indicators, " << code.masks.size() << " entries */\n";
+		out << "\t{\n";
+
+		if (words <= 1)
+			out << "\t\t" << type << " z = 0;\n";
+		else
+			out << "\t\tuint64_t z[" << words << "] = { 0 };\n";
+
+		out << "\n";
+
+		for (size_t d = 0; d < bits; d++)
+		{
+			out << "\t\tz";
+
+			if (words > 1)
+				out << "[" << d / 64 << "]";
+
+			out << " |= (" << type << ")" << negatedClause(code.definitions[d], false);
+
+			if (d % 64 > 0)
+				out << " << " << d % 64;
+
+			out << ";\n";
+		}
+
+		if (code.masks.empty())
+		{
+			out << "\t}\n";
+			return;
+		}
+
+		out << "\n";
+		out << "\t\tfor (j = 0; j < " << code.masks.size() << " && ";
+
+		if (words <= 1)
+			out << "(z & ~" << table << "[j])";
+		else
+			out << "bafsyn_outside(z, " << table << "[j], " << words << ")";
+
+		out << "; j++)\n";
+		out << "\t\t\t;\n";
+
+		writeStores(out, code, "\t\t");
+
+		out << "\t}\n";
+	}
+
+	void writeWordComponent(ostream& out, const ComponentCode& code, size_t c)
+	{
+		size_t bits = code.definitions.size();
+
+		out << "\t/* Component " << c << ": " << bits << " indicators, " << code.masks.size() << " entries */\n";
+		out << "\t{\n";
+
+		/* Indicators contained in every entry are never tested */
+		for (size_t d = 0; d < bits; d++)
+		{
+			bool tested = false;
+
+			for (const Vector<uint64_t>& mask : code.masks)
+				tested |= !((mask[d / 64] >> (d % 64)) & 1);
+
+			if (tested)
+				out << "\t\tconst uint64_t z" << d << " = " << negatedClause(code.definitions[d], true) << ";\n";
+		}
+
+		out << "\n";
+		out << "\t\trest = ~(uint64_t)0;\n";
+
+		/* Entry j takes the lanes left where no indicator outside it is true */
+		for (size_t j = 0; j < code.masks.size(); j++)
+		{
+			string outside;
+
+			for (size_t d = 0; d < bits; d++)
+			{
+				if ((code.masks[j][d / 64] >> (d % 64)) & 1)
+					continue;
+
+				outside += (outside.empty() ? "" : " | ") + string("z") + to_string(d);
+			}
+
+			out << "\t\tm = rest";
+
+			if (!outside.empty())
+				out << " & ~(" << outside << ")";
+
+			out << ";";
+
+			for (size_t k : code.outputs[j])
+				out << " y[" << k << "] |= m;";
+
+			out << " rest &= ~m;\n";
+		}
+
+		out << "\t}\n";
+	}
+}
+
+void generateC(ostream& out, const Model& model, const TrivialSpec& f1, const CNFSpec& spec)
+{
+	Vector<BVar> inputs(spec.inputVars().begin(), spec.inputVars().end());
+	Vector<BVar> outputs(spec.outputVars().begin(), spec.outputVars().end());
+
+	Map<BVar, size_t> inputPosition;
+	Map<BVar, size_t> outputPosition;
+
+	for (size_t k = 0; k < inputs.size(); k++)
+		inputPosition[inputs[k]] = k;
+
+	for (size_t k = 0; k < outputs.size(); k++)
+		outputPosition[outputs[k]] = k;
+
+	/* X_i of every z_i, over input positions */
+	Map<BVar, Vector<int>> definitionOf;
+
+	f1.forEach([&] (BVar z, const CNFClause& negDefinition)
+	{
+		Vector<int> definition;
+
+		for (BLit lit : negDefinition)
+		{
+			int k = inputPosition.at(abs(lit)) + 1;
+			definition.push_back((lit > 0) ? k : -k);
+		}
+
+		definitionOf[z] = definition;
+	});
+
+	Vector<ComponentCode> components;
+	bool multiword = false;
+
+	for (size_t c = 0; c < model.componentCount(); c++)
+	{
+		ComponentCode code;
+		Map<BVar, size_t> bit; /*< bit of every indicator of the component */
+
+		for (BVar z : model.allComponents()[c])
+		{
+			bit[z] = code.definitions.size();
+			code.definitions.push_back(definitionOf.at(z));
+		}
+
+		size_t words = wordCount(code.definitions.size());
+		multiword |= (words > 1);
+
+		for (const Set<BVar>& mss : model.mssForComponent(c))
+		{
+			Vector<uint64_t> mask(words, 0);
+			Vector<size_t> trueOutputs;
+
+			for (BVar var : mss)
+			{
+				if (bit.find(var) != bit.end())
+					mask[bit[var] / 64] |= uint64_t(1) << (bit[var] % 64);
+				else if (outputPosition.find(var) != outputPosition.end())
+					trueOutputs.push_back(outputPosition[var]);
+			}
+
+			code.masks.push_back(mask);
+			code.outputs.push_back(trueOutputs);
+		}
+
+		components.push_back(code);
+	}
+
+	out << "/* Generated by bafsyn: " << inputs.size() << " inputs, " << outputs.size() << " outputs, "
+	    << components.size() << " components, " << model.mssCount() << " entries. */\n\n";
+
+	out << "#include <stddef.h>\n";
+	out << "#include <stdint.h>\n\n";
+
+	out << "#ifdef __cplusplus\n";
+	out << "extern \"C\" {\n";
+	out << "#endif\n\n";
+
+	out << "#define BAFSYN_INPUTS " << inputs.size() << "\n";
+	out << "#define BAFSYN_OUTPUTS " << outputs.size() << "\n\n";
+
+	/* Zero-length arrays are not valid C, keep one element */
+	out << "/* DIMACS variable of every input and output, by position */\n";
+	out << "const int bafsyn_input_vars[" << std::max<size_t>(inputs.size(), 1) << "] = {";
+	for (size_t k = 0; k < inputs.size(); k++)
+		out << ((k > 0) ? ", " : " ") << inputs[k];
+	out << " };\n";
+
+	out << "const int bafsyn_output_vars[" << std::max<size_t>(outputs.size(), 1) << "] = {";
+	for (size_t k = 0; k < outputs.size(); k++)
+		out << ((k > 0) ? ", " : " ") << outputs[k];
+	out << " };\n\n";
+
+	for (size_t c = 0; c < components.size(); c++)
+		writeMaskTable(out, components[c], c);
+
+	if (multiword)
+	{
+		out << "/* Whether some bit of z is outside the mask */\n";
+		out << "static int bafsyn_outside(const uint64_t* z, const uint64_t* mask, size_t words)\n";
+		out << "{\n";
+		out << "\tsize_t w;\n\n";
+		out << "\tfor (w = 0; w < words; w++)\n";
+		out << "\t\tif (z[w] & ~mask[w])\n";
+		out << "\t\t\treturn 1;\n\n";
+		out << "\treturn 0;\n";
+		out << "}\n\n";
+	}
+
+	out << "/* Sets y[k] to the value of output k for the input where x[k] is the value of input k (0 or 1) */\n";
+	out << "void bafsyn_eval(const uint8_t* x, uint8_t* y)\n";
+	out << "{\n";
+	out << "\tsize_t j;\n\n";
+	out << "\tfor (j = 0; j < BAFSYN_OUTPUTS; j++)\n";
+	out << "\t\ty[j] = 0;\n";
+
+	for (size_t c = 0; c < components.size(); c++)
+	{
+		out << "\n";
+		writeScalarComponent(out, components[c], c);
+	}
+
+	out << "\n";
+	out << "\t(void)x;\n";
+	out << "\t(void)j;\n";
+	out << "}\n\n";
+
+	out << "/* Same as bafsyn_eval on 64 inputs at once: bit l of x[k] and y[k] belongs to input l */\n";
+	out << "void bafsyn_eval64(const uint64_t* x, uint64_t* y)\n";
+	out << "{\n";
+	out << "\tuint64_t rest, m;\n";
+	out << "\tsize_t k;\n\n";
+	out << "\tfor (k = 0; k < BAFSYN_OUTPUTS; k++)\n";
+	out << "\t\ty[k] = 0;\n";
+
+	for (size_t c = 0; c < components.size(); c++)
+	{
+		out << "\n";
+		writeWordComponent(out, components[c], c);
+	}
+
+	out << "\n";
+	out << "\t(void)x;\n";
+	out << "\t(void)rest;\n";
+	out << "\t(void)m;\n";
+	out << "}\n\n";
+
+	out << "#ifdef __cplusplus\n";
+	out << "}\n";
+	out << "#endif\n";
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "CNFFormula.hpp"
+#include "CNFSpec.hpp"
+#include "TrivialSpec.hpp"
+#include "Model.hpp"
+
+#include <ostream>
+
+/**
+ * Writes a self-contained C source file (also valid C++) implementing the synthesized function.
+ *
+ * Inputs and outputs are numbered by increasing variable, and the file lists their DIMACS
+ * variables in bafsyn_input_vars and bafsyn_output_vars. Two functions are generated:
+ *
+ * - void bafsyn_eval(const uint8_t* x, uint8_t* y): one input, x[k] and y[k] are 0 or 1.
+ *   The indicators of every component are packed in the smallest unsigned type holding them
+ *   (words of 64 bits beyond that), and the first entry whose mask contains them is found by
+ *   scanning a constant table of masks; its outputs are then stored by a switch.
+ *
+ * - void bafsyn_eval64(const uint64_t* x, uint64_t* y): 64 inputs at once, bit l of x[k]
+ *   and y[k] holds the value for input l. Every z_i <-> ~X_i is one word expression, and the
+ *   first match of all lanes is computed without branches, entry by entry.
+ *
+ * The order of the decision lists is kept, so the generated code returns the same outputs as
+ * the model does with first-match semantics.
+ */
+void generateC(std::ostream& out, const Model& model, const TrivialSpec& f1, const CNFSpec& spec);
@@ -0,0 +1,179 @@
+#include "CompiledModel.hpp"
+#include "Simulator.hpp"
+#include "Map.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+using std::move;
+
+const uint32_t CompiledModel::noEntry;
+
+CompiledModel::CompiledModel(const Model& model,
+                             const TrivialSpec& f1,
+                             const Set<BVar>& outputVars,
+                             size_t supportLimit)
+{
+	if (supportLimit > 24)
+		throw std::invalid_argument("Support limit too large for tables");
+
+	Vector<BVar> defined; /*< z_1, ..., z_n */
+	Map<BVar, size_t> definitionOf; /*< definitionOf[z_i] == i */
+
+	f1.forEach([&] (BVar z, const CNFClause& negDefinition)
+	{
+		definitionOf[z] = defined.size();
+		defined.push_back(z);
+		_negDefinitions.push_back(negDefinition);
+	});
+
+	Simulator simulator(f1);
+
+	for (size_t c = 0; c < model.componentCount(); c++)
+	{
+		Component component;
+
+		for (BVar z : model.allComponents()[c])
+			component.definitions.push_back(definitionOf.at(z));
+
+		const Vector<size_t>& definitions = component.definitions;
+		const Vector<Set<BVar>>& entries = model.mssForComponent(c);
+
+		/* Indicators of every entry, as bit vectors over the definitions of the component */
+		Vector<Vector<bool>> indicators(entries.size(), Vector<bool>(definitions.size()));
+
+		for (size_t j = 0; j < entries.size(); j++)
+		{
+			Vector<BVar> outputs;
+
+			for (BVar var : entries[j])
+			{
+				if (outputVars.find(var) != outputVars.end())
+					outputs.push_back(var);
+			}
+
+			for (size_t d = 0; d < definitions.size(); d++)
+				indicators[j][d] = entries[j].find(defined[definitions[d]]) != entries[j].end();
+
+			_entryOutputs.push_back(outputs);
+		}
+
+		component.firstEntry = _entryOutputs.size() - entries.size();
+
+		Vector<size_t> cone = simulator.cone(definitions);
+
+		for (size_t k : cone)
+			component.support.push_back(simulator.inputs()[k]);
+
+		component.tabulated = (cone.size() <= supportLimit);
+		component.tableOffset = _tables.size();
+
+		if (component.tabulated)
+		{
+			size_t cells = size_t(1) << cone.size();
+			size_t blocks = (cells + 63) / 64;
+
+			_tables.resize(_tables.size() + cells, noEntry);
+
+			for (size_t block = 0; block < blocks; block++)
+			{
+				Vector<uint64_t> lanes = simulator.simulate(simulator.exhaustiveStimulus(cone, block), definitions);
+
+				/* First match for all 64 inputs at once: entry j matches the lanes where no z outside it is true */
+				uint64_t remaining = (cells >= 64) ? ~uint64_t(0) : (uint64_t(1) << cells) - 1;
+
+				for (size_t j = 0; j < entries.size() && remaining; j++)
+				{
+					uint64_t match = remaining;
+
+					for (size_t d = 0; d < definitions.size(); d++)
+						if (!indicators[j][d])
+							match &= ~lanes[d];
+
+					for (size_t lane = 0; lane < 64; lane++)
+						if ((match >> lane) & 1)
+							_tables[component.tableOffset + 64 * block + lane] = j;
+
+					remaining &= ~match;
+				}
+			}
+		}
+		else
+		{
+			for (size_t i : definitions)
+				component.indicators.push_back(defined[i]);
+
+			for (size_t j = 0; j < entries.size(); j++)
+				component.index.insert(setIntersection(entries[j], model.allComponents()[c]), j);
+		}
+
+		_components.push_back(move(component));
+	}
+}
+
+uint32_t CompiledModel::entryFor(const Component& component, const Set<BVar>& inputAssignment) const
+{
+	if (component.tabulated)
+	{
+		size_t index = 0;
+
+		for (size_t k = 0; k < component.support.size(); k++)
+			if (inputAssignment.find(component.support[k]) != inputAssignment.end())
+				index |= size_t(1) << k;
+
+		return _tables[component.tableOffset + index];
+	}
+
+	/* z_i is true iff X_i is false */
+	Set<BVar> active;
+
+	for (size_t d = 0; d < component.definitions.size(); d++)
+		if (!_negDefinitions[component.definitions[d]].eval(inputAssignment))
+			active.insert(component.indicators[d]);
+
+	size_t entry = component.index.findSuperset(active);
+
+	if (entry != SetTrie::none)
+		return entry;
+
+	return noEntry;
+}
+
+Set<BVar> CompiledModel::eval(const Set<BVar>& inputAssignment) const
+{
+	Set<BVar> outputAssignment;
+
+	for (const Component& component : _components)
+	{
+		uint32_t entry = entryFor(component, inputAssignment);
+
+		if (entry == noEntry)
+			throw std::runtime_error("Input not covered by the model");
+
+		for (BVar y : _entryOutputs[component.firstEntry + entry])
+			outputAssignment.insert(y);
+	}
+
+	return outputAssignment;
+}
+
+size_t CompiledModel::componentCount() const
+{
+	return _components.size();
+}
+
+size_t CompiledModel::tabulatedCount() const
+{
+	size_t count = 0;
+
+	for (const Component& component : _components)
+		if (component.tabulated)
+			count++;
+
+	return count;
+}
+
+size_t CompiledModel::tableSize() const
+{
+	return _tables.size();
+}
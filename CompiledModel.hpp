@@ -0,0 +1,61 @@
+#pragma once
+
+#include "CNFFormula.hpp"
+#include "TrivialSpec.hpp"
+#include "Model.hpp"
+#include "SetTrie.hpp"
+#include "Set.hpp"
+#include "Vector.hpp"
+
+#include <cstdint>
+
+/**
+ * Form of a Model optimized for evaluation.
+ *
+ * A component whose definitions read at most supportLimit inputs is compiled to a
+ * dense table indexed by the values of those inputs, holding the index of the first
+ * entry of the decision list that covers the input, so it is evaluated with a single
+ * load. The tables of all components are stored back to back in one array. Wider
+ * components look the first covering entry up in a SetTrie index. Entries only keep
+ * their y part, which is all evaluation needs.
+ */
+class CompiledModel
+{
+	struct Component
+	{
+		Vector<size_t> definitions; /*< indices i of the definitions z_i <-> ~X_i in the component */
+		Vector<BVar> support; /*< inputs of the definitions, bit k of a table index is the value of support[k] */
+		bool tabulated; /*< whether the component has a table */
+		size_t tableOffset; /*< position of the table in _tables */
+		size_t firstEntry; /*< position of the first entry of the component in _entryOutputs */
+		Vector<BVar> indicators; /*< z_i for every definition of the component (wide components only) */
+		SetTrie index; /*< indicators of every entry, by position in the list (wide components only) */
+	};
+
+	Vector<Component> _components;
+	Vector<uint32_t> _tables; /*< tables of all tabulated components, entry indices relative to the component */
+	Vector<Vector<BVar>> _entryOutputs; /*< y variables set to true by each entry, for all components */
+	Vector<CNFClause> _negDefinitions; /*< X_1, ..., X_n */
+
+	/** Index of the entry of the component covering the given input */
+	uint32_t entryFor(const Component& component, const Set<BVar>& inputAssignment) const;
+
+public:
+
+	/** Marks inputs not covered by any entry, which only happens if the model is wrong */
+	static const uint32_t noEntry = UINT32_MAX;
+
+	/** Compiles the model, using tables for the components reading at most supportLimit (at most 24) inputs */
+	CompiledModel(const Model& model, const TrivialSpec& f1, const Set<BVar>& outputVars, size_t supportLimit);
+
+	/** Returns the output variables set to true for the given assignment (set of input variables set to true) */
+	Set<BVar> eval(const Set<BVar>& inputAssignment) const;
+
+	size_t componentCount() const;
+
+	/** Number of components evaluated by a table */
+	size_t tabulatedCount() const;
+
+	/** Total number of cells in the tables */
+	size_t tableSize() const;
+};
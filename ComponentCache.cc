@@ -0,0 +1,183 @@
+#include "ComponentCache.hpp"
+#include "Map.hpp"
+#include "ModelFile.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+using std::string;
+using std::runtime_error;
+
+static_assert(sizeof(ComponentCacheHeader) == 40, "Component cache header must have no padding");
+
+namespace
+{
+	const char componentCacheMagic[8] = "BAFSYNC";
+	const uint32_t componentCacheVersion = 1;
+
+	/** Bytes of the key and its padding */
+	size_t paddedSize(size_t bytes)
+	{
+		return (bytes + 7) & ~size_t(7);
+	}
+
+	/** Distinguishes the temporary files of concurrent stores of one process */
+	std::atomic<uint64_t> storeCounter { 0 };
+}
+
+ComponentCache::ComponentCache(const string& dir) : _dir(dir)
+{
+	if (mkdir(dir.c_str(), 0777) != 0 && errno != EEXIST)
+		throw runtime_error("Could not create cache directory " + dir + ": " + std::strerror(errno));
+
+	struct stat status;
+
+	if (stat(dir.c_str(), &status) != 0 || !S_ISDIR(status.st_mode))
+		throw runtime_error(dir + " is not a directory");
+}
+
+string ComponentCache::pathOf(const CanonicalComponent& canon, bool approximate) const
+{
+	/* FNV-1a over the key, then the kind of list */
+	uint64_t hash = 0xcbf29ce484222325;
+
+	for (char c : canon.key)
+		hash = (hash ^ uint8_t(c)) * 0x100000001b3;
+
+	hash = (hash ^ (approximate ? 1 : 0)) * 0x100000001b3;
+
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.mss", static_cast<unsigned long long>(hash));
+
+	return _dir + "/" + name;
+}
+
+Optional<Vector<Set<BVar>>> ComponentCache::load(const CanonicalComponent& canon, bool acceptApproximate) const
+{
+	Optional<Vector<Set<BVar>>> entries = read(canon, false);
+
+	if (!entries && acceptApproximate)
+		entries = read(canon, true);
+
+	if (entries)
+		_hits++;
+	else
+		_misses++;
+
+	return entries;
+}
+
+Optional<Vector<Set<BVar>>> ComponentCache::read(const CanonicalComponent& canon, bool approximate) const
+{
+	std::ifstream file(pathOf(canon, approximate), std::ios::binary);
+	ComponentCacheHeader header;
+
+	size_t k = canon.indicators.size();
+	size_t n = k + canon.outputs.size();
+
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+	    std::memcmp(header.magic, componentCacheMagic, sizeof(header.magic)) != 0 ||
+	    header.version != componentCacheVersion ||
+	    header.byteOrderMark != modelFileByteOrderMark ||
+	    header.approximate != (approximate ? 1 : 0) ||
+	    header.keySize != canon.key.size() ||
+	    header.indicatorCount != k || header.outputCount != n - k ||
+	    header.maskWords != (n + 63) / 64)
+		return nullopt;
+
+	string key(paddedSize(header.keySize), '\0');
+	Vector<uint64_t> masks(size_t(header.entryCount) * header.maskWords);
+
+	if (!file.read(&key[0], key.size()) ||
+	    key.compare(0, header.keySize, canon.key) != 0 ||
+	    !file.read(reinterpret_cast<char*>(masks.data()), masks.size() * sizeof(uint64_t)))
+		return nullopt;
+
+	Vector<Set<BVar>> entries(header.entryCount);
+
+	for (size_t e = 0; e < entries.size(); e++)
+	{
+		const uint64_t* mask = &masks[e * header.maskWords];
+
+		for (size_t p = 0; p < n; p++)
+			if (mask[p / 64] & (uint64_t(1) << (p % 64)))
+				entries[e].insert((p < k) ? canon.indicators[p] : canon.outputs[p - k]);
+	}
+
+	return entries;
+}
+
+void ComponentCache::store(const CanonicalComponent& canon, bool approximate, const Vector<Set<BVar>>& entries) const
+{
+	size_t k = canon.indicators.size();
+	size_t n = k + canon.outputs.size();
+
+	Map<BVar, size_t> position;
+
+	for (size_t p = 0; p < k; p++)
+		position[canon.indicators[p]] = p;
+
+	for (size_t p = 0; p < n - k; p++)
+		position[canon.outputs[p]] = k + p;
+
+	ComponentCacheHeader header;
+	std::memcpy(header.magic, componentCacheMagic, sizeof(header.magic));
+	header.version = componentCacheVersion;
+	header.byteOrderMark = modelFileByteOrderMark;
+	header.approximate = approximate ? 1 : 0;
+	header.keySize = canon.key.size();
+	header.indicatorCount = k;
+	header.outputCount = n - k;
+	header.entryCount = entries.size();
+	header.maskWords = (n + 63) / 64;
+
+	Vector<uint64_t> masks(entries.size() * header.maskWords, 0);
+
+	for (size_t e = 0; e < entries.size(); e++)
+		for (BVar var : entries[e])
+		{
+			size_t p = position.at(var);
+			masks[e * header.maskWords + p / 64] |= uint64_t(1) << (p % 64);
+		}
+
+	string key = canon.key;
+	key.resize(paddedSize(key.size()), '\0');
+
+	string path = pathOf(canon, approximate);
+	string temporary = path + ".tmp." + std::to_string(getpid()) + "." + std::to_string(storeCounter++);
+
+	std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(key.data(), key.size());
+	file.write(reinterpret_cast<const char*>(masks.data()), masks.size() * sizeof(uint64_t));
+	file.close();
+
+	/* The component is solved already, so a full or read-only cache only loses the list */
+	if (!file || std::rename(temporary.c_str(), path.c_str()) != 0)
+	{
+		std::remove(temporary.c_str());
+		_failedStores++;
+	}
+}
+
+size_t ComponentCache::hits() const
+{
+	return _hits;
+}
+
+size_t ComponentCache::misses() const
+{
+	return _misses;
+}
+
+size_t ComponentCache::failedStores() const
+{
+	return _failedStores;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Isomorphism.hpp"
+#include "Optional.hpp"
+#include "Set.hpp"
+#include "Vector.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Content-addressed directory of component lists, shared by runs on related specifications.
+ *
+ * A list only depends on the canonical form of its component (see Isomorphism.hpp), so the
+ * entries are stored by canonical position in a file named by a 64-bit FNV-1a hash of the
+ * key and of the kind of list (exact MSS, or entries that need not be maximal as in approximate
+ * mode and input enumeration; exact runs only read exact lists):
+ *
+ * - ComponentCacheHeader;
+ * - the key, padded with zeros to a multiple of 8 bytes;
+ * - uint64_t[entryCount * maskWords]: bit p of an entry is the indicator at canonical
+ *   position p, bit indicatorCount + p the output at position p.
+ *
+ * The key is checked on load, so hash collisions only cost a miss. Files are written to a
+ * temporary name and renamed, so concurrent runs sharing the directory never read a partial
+ * file. Unreadable, truncated or foreign files are treated as misses, and writes are best
+ * effort: a list that cannot be stored (full disk, read-only directory) is only counted.
+ */
+struct ComponentCacheHeader
+{
+	char magic[8]; /*< "BAFSYNC" */
+	uint32_t version;
+	uint32_t byteOrderMark; /*< modelFileByteOrderMark */
+	uint32_t approximate; /*< 1 if the entries need not be maximal */
+	uint32_t keySize; /*< in bytes */
+	uint32_t indicatorCount;
+	uint32_t outputCount;
+	uint32_t entryCount;
+	uint32_t maskWords;
+};
+
+class ComponentCache
+{
+	std::string _dir;
+	mutable std::atomic<size_t> _hits { 0 };
+	mutable std::atomic<size_t> _misses { 0 };
+	mutable std::atomic<size_t> _failedStores { 0 };
+
+	std::string pathOf(const CanonicalComponent& canon, bool approximate) const;
+
+	/** Stored list of the given kind, if any */
+	Optional<Vector<Set<BVar>>> read(const CanonicalComponent& canon, bool approximate) const;
+
+public:
+
+	/** Uses the directory at dir, which is created if missing */
+	explicit ComponentCache(const std::string& dir);
+
+	ComponentCache(const ComponentCache&) = delete;
+	ComponentCache& operator=(const ComponentCache&) = delete;
+
+	/**
+	 * Stored list of the component with this form, over its own variables, if any: the exact
+	 * list, or if there is none and acceptApproximate is set, a list that need not be maximal
+	 */
+	Optional<Vector<Set<BVar>>> load(const CanonicalComponent& canon, bool acceptApproximate) const;
+
+	/**
+	 * Stores the list of the component with this form, replacing any stored one of the same
+	 * kind (approximate if the entries need not be maximal). Failures are only counted.
+	 */
+	void store(const CanonicalComponent& canon, bool approximate, const Vector<Set<BVar>>& entries) const;
+
+	/** Successful and failed loads so far, and lists that could not be stored */
+	size_t hits() const;
+	size_t misses() const;
+	size_t failedStores() const;
+};
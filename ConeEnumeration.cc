@@ -0,0 +1,91 @@
+#include "ConeEnumeration.hpp"
+#include "ApproximateMSS.hpp"
+#include "SynthesisOptions.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+using std::sort;
+
+Vector<Set<BVar>> coneEnumerationEntries(const Simulator& simulator,
+                                         const Vector<size_t>& definitions,
+                                         const Vector<BVar>& indicators,
+                                         const Vector<CNFClause>& clauses)
+{
+	Vector<size_t> cone = simulator.cone(definitions);
+
+	if (cone.size() > coneEnumerationLimit)
+		throw std::invalid_argument("Input cone too large for enumeration");
+
+	size_t blocks = (cone.size() <= 6) ? 1 : size_t(1) << (cone.size() - 6);
+
+	/* Distinct sets of z_i made true by some assignment, as bit vectors over the definitions */
+	Set<Vector<bool>> patterns;
+
+	for (size_t block = 0; block < blocks; block++)
+	{
+		Vector<uint64_t> lanes = simulator.simulate(simulator.exhaustiveStimulus(cone, block), definitions);
+
+		for (size_t lane = 0; lane < 64; lane++)
+		{
+			Vector<bool> pattern(definitions.size());
+
+			for (size_t d = 0; d < definitions.size(); d++)
+				pattern[d] = (lanes[d] >> lane) & 1;
+
+			patterns.insert(pattern);
+		}
+	}
+
+	/* Largest patterns first, so that the patterns they subsume are covered by their entries */
+	Vector<Vector<bool>> ordered(patterns.begin(), patterns.end());
+
+	auto count = [] (const Vector<bool>& pattern) { return std::count(pattern.begin(), pattern.end(), true); };
+
+	sort(ordered.begin(), ordered.end(),
+	     [&count] (const Vector<bool>& a, const Vector<bool>& b) { return count(a) > count(b); });
+
+	ApproximateMSS engine(indicators, clauses);
+
+	Vector<Set<BVar>> entries;
+	Vector<Vector<bool>> covered; /*< covered[j][d] is set if entries[j] contains z_d */
+
+	for (const Vector<bool>& pattern : ordered)
+	{
+		auto coversPattern = [&pattern] (const Vector<bool>& entry)
+		{
+			for (size_t d = 0; d < pattern.size(); d++)
+				if (pattern[d] && !entry[d])
+					return false;
+
+			return true;
+		};
+
+		if (std::any_of(covered.begin(), covered.end(), coversPattern))
+			continue;
+
+		Set<BVar> vars;
+
+		for (size_t d = 0; d < pattern.size(); d++)
+			if (pattern[d])
+				vars.insert(indicators[d]);
+
+		Optional<Set<BVar>> entry = engine.newSetCovering(vars);
+
+		if (!entry)
+		{
+			/* This branch will never be reached if the specification is realizable */
+			throw Unrealizable();
+		}
+
+		Vector<bool> entryBits(definitions.size());
+
+		for (size_t d = 0; d < definitions.size(); d++)
+			entryBits[d] = entry->find(indicators[d]) != entry->end();
+
+		covered.push_back(entryBits);
+		entries.push_back(*entry);
+	}
+
+	return entries;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CNFFormula.hpp"
+#include "Simulator.hpp"
+#include "Set.hpp"
+#include "Vector.hpp"
+
+/**
+ * Computes the decision list of a component whose definitions depend on few inputs
+ * by enumerating every assignment to those inputs, without the MFS/MSS loop.
+ *
+ * - simulator: bit-parallel evaluator of F1.
+ * - definitions: indices i of the definitions z_i <-> ~X_i in the component,
+ *   whose input cone must have at most coneEnumerationLimit inputs.
+ * - indicators: z_i for every index in definitions, in the same order.
+ * - clauses: Y_i for every index in definitions, in the same order.
+ *
+ * The assignments are simulated 64 at a time and grouped by the set of z_i they make
+ * true. Patterns are processed from largest to smallest, and every pattern not covered
+ * by an entry yet gets one SAT call (see ApproximateMSS), so subsumed patterns cost
+ * nothing. Entries are represented in the same way as in MSSGenerator: by the set of
+ * z and y variables set to true. Throws Unrealizable if some pattern is not satisfiable, which only
+ * happens if the specification is unrealizable.
+ */
+Vector<Set<BVar>> coneEnumerationEntries(const Simulator& simulator,
+                                         const Vector<size_t>& definitions,
+                                         const Vector<BVar>& indicators,
+                                         const Vector<CNFClause>& clauses);
+
+/** Maximum number of inputs in the cone accepted by coneEnumerationEntries */
+const size_t coneEnumerationLimit = 24;
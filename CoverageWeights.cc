@@ -0,0 +1,62 @@
+#include "CoverageWeights.hpp"
+
+#include <algorithm>
+#include <utility>
+
+using std::max_element;
+using std::move;
+
+CoverageWeights::CoverageWeights(Vector<BVar> indicators,
+                                 const Vector<size_t>& degrees,
+                                 size_t window)
+	: _indicators(move(indicators))
+	, _window(window)
+{
+	size_t maxDegree = degrees.empty() ? 0 : *max_element(degrees.begin(), degrees.end());
+
+	for (size_t i = 0; i < _indicators.size(); i++)
+	{
+		/* Fewer conflicts means the indicator fits into more MFS */
+		_baseWeight[_indicators[i]] = 1 + (maxDegree - degrees[i]);
+		_missCount[_indicators[i]] = 0;
+	}
+
+	/* A single miss outweighs any difference in degree */
+	_missWeight = maxDegree + 1;
+}
+
+void CoverageWeights::recordMSS(const Set<BVar>& mss)
+{
+	if (_window == 0)
+		return;
+
+	Set<BVar> misses;
+
+	for (BVar v : _indicators)
+		if (mss.find(v) == mss.end())
+			misses.insert(v);
+
+	for (BVar v : misses)
+		_missCount[v]++;
+
+	_recentMisses.push_back(move(misses));
+
+	/* Forget the oldest MSS once the window is full */
+	if (_recentMisses.size() > _window)
+	{
+		for (BVar v : _recentMisses.front())
+			_missCount[v]--;
+
+		_recentMisses.pop_front();
+	}
+}
+
+Map<BVar, uint64_t> CoverageWeights::weights() const
+{
+	Map<BVar, uint64_t> w;
+
+	for (BVar v : _indicators)
+		w[v] = _baseWeight.at(v) + _missWeight * _missCount.at(v);
+
+	return w;
+}
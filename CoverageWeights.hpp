@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CNFFormula.hpp"
+#include "Set.hpp"
+#include "Map.hpp"
+#include "Vector.hpp"
+
+#include <cstdint>
+#include <deque>
+
+/**
+ * Estimates, for every indicator variable of a component, how likely it is to
+ * appear in MFS that have not been covered yet. The estimate is used as the
+ * weight of the soft clause (z_i) when computing an MSS, so that the MSS
+ * returned for an MFS tends to also cover the MFS that will be found next.
+ *
+ * The estimate combines two sources:
+ * - Conflict-graph degree: an indicator with few conflicts is compatible with
+ *   more indicators, and so belongs to more MFS;
+ * - Recent MSS: an MFS that is still uncovered is not a subset of any MSS found
+ *   so far, so it must contain indicators left out of those MSS. Indicators
+ *   missing from many of the last MSS are the ones the next MFS will contain.
+ */
+class CoverageWeights
+{
+	Vector<BVar> _indicators; /*< indicator variables of the component */
+	Map<BVar, uint64_t> _baseWeight; /*< weight derived from the conflict-graph degree */
+	Map<BVar, uint64_t> _missCount; /*< number of recent MSS not containing the indicator */
+	uint64_t _missWeight; /*< weight of a single miss */
+
+	std::deque<Set<BVar>> _recentMisses; /*< for each recent MSS, the indicators it does not contain */
+	size_t _window; /*< maximum number of MSS kept in the window */
+
+public:
+
+	/**
+	 * Constructs the estimator for a component.
+	 * - indicators: indicator variables of the component.
+	 * - degrees: degrees[i] is the conflict-graph degree of indicators[i].
+	 * - window: number of recent MSS taken into account.
+	 */
+	CoverageWeights(Vector<BVar> indicators, const Vector<size_t>& degrees, size_t window);
+
+	/** Records an MSS added to the model */
+	void recordMSS(const Set<BVar>& mss);
+
+	/** Current weight of every indicator variable (always at least 1) */
+	Map<BVar, uint64_t> weights() const;
+};
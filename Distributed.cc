@@ -0,0 +1,784 @@
+#include "Distributed.hpp"
+#include "Algorithm.hpp"
+#include "CNFFormula.hpp"
+#include "Optional.hpp"
+#include "Set.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using std::string;
+using std::runtime_error;
+using std::istringstream;
+
+namespace
+{
+	/** Version of the protocol, exchanged in the hello lines */
+	const int protocolVersion = 3;
+
+	/** Time a connecting process has to send its hello line, in seconds */
+	const int helloTimeout = 10;
+
+	/** Line-based view of a stream socket */
+	class Channel
+	{
+		int _fd;
+		string _buffer;
+
+	public:
+
+		explicit Channel(int fd) : _fd(fd) {}
+
+		/** Reads the next line, without its newline. Returns false at the end of the stream or on an error. */
+		bool readLine(string& line)
+		{
+			size_t newline;
+			size_t scanned = 0;
+
+			while ((newline = _buffer.find('\n', scanned)) == string::npos)
+			{
+				char chunk[65536];
+				ssize_t n = recv(_fd, chunk, sizeof(chunk), 0);
+
+				if (n < 0 && errno == EINTR)
+					continue;
+				if (n <= 0)
+					return false;
+
+				scanned = _buffer.size();
+				_buffer.append(chunk, n);
+			}
+
+			line = _buffer.substr(0, newline);
+			_buffer.erase(0, newline + 1);
+
+			return true;
+		}
+
+		/** Sends the text, returns false if the connection is broken */
+		bool write(const string& text)
+		{
+			for (size_t sent = 0; sent < text.size();)
+			{
+				ssize_t n = send(_fd, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+
+				if (n >= 0)
+					sent += n;
+				else if (errno != EINTR)
+					return false;
+			}
+
+			return true;
+		}
+	};
+
+	/** Sub-problem of one component: its definitions and, for cube tasks, the cube */
+	struct Task
+	{
+		Vector<BVar> indicators;
+		Vector<CNFClause> negDefinitions; /*< X_i */
+		Vector<CNFClause> outputClauses; /*< Y_i */
+		Optional<Cube> cube;
+		Vector<Set<BVar>> known; /*< entries found for other cubes of the component, blocked before the search */
+		bool approximate = false; /*< options of the coordinator that change the entries */
+		size_t coneSize = 0;
+	};
+
+	void appendList(string& out, const CNFClause& clause)
+	{
+		for (BLit lit : clause)
+			out += std::to_string(lit) + " ";
+
+		out += "0";
+	}
+
+	void appendList(string& out, const Set<BVar>& vars)
+	{
+		for (BVar var : vars)
+			out += std::to_string(var) + " ";
+
+		out += "0";
+	}
+
+	/** Reads literals up to the terminating 0 */
+	CNFClause readClause(istringstream& in)
+	{
+		CNFClause clause;
+		BLit lit;
+
+		while (in >> lit && lit != 0)
+			clause |= lit;
+
+		if (!in)
+			throw runtime_error("Malformed message: unterminated list");
+
+		return clause;
+	}
+
+	Set<BVar> readVars(istringstream& in)
+	{
+		Set<BVar> vars;
+
+		for (BLit lit : readClause(in))
+			vars.insert(lit);
+
+		return vars;
+	}
+
+	string encodeTask(size_t id, const Task& task)
+	{
+		string message = "task " + std::to_string(id) + " " + std::to_string(task.indicators.size()) +
+			(task.cube ? " 1 " : " 0 ") + std::to_string(task.known.size()) +
+			(task.approximate ? " 1 " : " 0 ") + std::to_string(task.coneSize) + "\n";
+
+		for (size_t i = 0; i < task.indicators.size(); i++)
+		{
+			message += std::to_string(task.indicators[i]) + " ";
+			appendList(message, task.negDefinitions[i]);
+			message += " ";
+			appendList(message, task.outputClauses[i]);
+			message += "\n";
+		}
+
+		if (task.cube)
+		{
+			message += "cube ";
+			appendList(message, task.cube->in);
+			message += " ";
+			appendList(message, task.cube->out);
+			message += "\n";
+		}
+
+		for (const Set<BVar>& entry : task.known)
+		{
+			appendList(message, entry);
+			message += "\n";
+		}
+
+		return message;
+	}
+
+	/** Reads the rest of a task whose first line is header, returns false if the stream ends first */
+	bool readTask(Channel& channel, const string& header, size_t& id, Task& task)
+	{
+		istringstream in(header);
+		string keyword;
+		size_t count, known;
+		int cubed, approximate;
+
+		if (!(in >> keyword >> id >> count >> cubed >> known >> approximate >> task.coneSize) || keyword != "task")
+			throw runtime_error("Malformed task: " + header);
+
+		task.approximate = (approximate != 0);
+
+		string line;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			if (!channel.readLine(line))
+				return false;
+
+			istringstream definition(line);
+			BVar z;
+
+			if (!(definition >> z))
+				throw runtime_error("Malformed definition: " + line);
+
+			task.indicators.push_back(z);
+			task.negDefinitions.push_back(readClause(definition));
+			task.outputClauses.push_back(readClause(definition));
+		}
+
+		if (cubed)
+		{
+			if (!channel.readLine(line))
+				return false;
+
+			istringstream cube(line);
+
+			if (!(cube >> keyword) || keyword != "cube")
+				throw runtime_error("Malformed cube: " + line);
+
+			Cube c;
+			c.in = readVars(cube);
+			c.out = readVars(cube);
+			task.cube = c;
+		}
+
+		for (size_t k = 0; k < known; k++)
+		{
+			if (!channel.readLine(line))
+				return false;
+
+			istringstream entry(line);
+			task.known.push_back(readVars(entry));
+		}
+
+		return true;
+	}
+
+	/** Entries of a task, computed in this process */
+	Vector<Set<BVar>> solveTask(const Task& task, const SynthesisOptions& workerOptions)
+	{
+		/* Entries are exact MSS only if the coordinator asked for them */
+		SynthesisOptions options = workerOptions;
+		options.approximate = task.approximate;
+		options.coneSize = task.coneSize;
+
+		Set<BVar> outputVars;
+		CNFFormula outputCNF;
+
+		for (const CNFClause& clause : task.outputClauses)
+		{
+			outputCNF &= clause;
+
+			for (BLit lit : clause)
+				outputVars.insert(abs(lit));
+		}
+
+		TrivialSpec f1(task.indicators, task.negDefinitions);
+		MSSSpec f2(task.indicators, outputVars, outputCNF);
+
+		if (task.cube)
+			return coverCube(f1, f2, *task.cube, task.known, options);
+
+		/* The definitions form one connected component, so the model has a single list */
+		Model model = BAFConnectedComponents(f1, f2, options);
+		Vector<Set<BVar>> entries;
+
+		for (size_t c = 0; c < model.componentCount(); c++)
+			for (const Set<BVar>& mss : model.mssForComponent(c))
+				entries.push_back(mss);
+
+		return entries;
+	}
+
+	string helloLine(const string& token)
+	{
+		return "hello " + std::to_string(protocolVersion) + (token.empty() ? "" : " " + token) + "\n";
+	}
+
+	/** Reads the hello line of the other side, returns false if it is missing, of another version or token */
+	bool readHello(Channel& channel, const string& token)
+	{
+		string line;
+		return channel.readLine(line) && line + "\n" == helloLine(token);
+	}
+
+	/**
+	 * Exchanges hello lines with a worker that has just connected: the worker speaks first, and
+	 * must do so within helloTimeout. Returns false if it is not a worker of this version
+	 * presenting the token.
+	 */
+	bool greetWorker(int fd, const string& token)
+	{
+		timeval timeout = { helloTimeout, 0 };
+		timeval none = { 0, 0 };
+
+		setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+		Channel channel(fd);
+		bool greeted = readHello(channel, token) && channel.write(helloLine(token));
+
+		setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &none, sizeof(none));
+
+		return greeted;
+	}
+
+	/** Serves the tasks of the coordinator on the connection until it is closed */
+	void serveCoordinator(int fd, const string& token, const SynthesisOptions& options)
+	{
+		Channel channel(fd);
+		string header;
+
+		if (!channel.write(helloLine(token)) || !readHello(channel, token))
+		{
+			close(fd);
+			throw runtime_error("The coordinator does not speak protocol version " + std::to_string(protocolVersion) +
+			                    " or does not have the same token");
+		}
+
+		while (channel.readLine(header))
+		{
+			size_t id = 0;
+			Task task;
+			string reply;
+
+			try
+			{
+				if (!readTask(channel, header, id, task))
+					break;
+
+				Vector<Set<BVar>> entries = solveTask(task, options);
+
+				reply = "result " + std::to_string(id) + " " + std::to_string(entries.size()) + "\n";
+
+				for (const Set<BVar>& entry : entries)
+				{
+					appendList(reply, entry);
+					reply += "\n";
+				}
+			}
+			catch (const Unrealizable&)
+			{
+				reply = "unrealizable " + std::to_string(id) + "\n";
+			}
+			catch (const std::exception& e)
+			{
+				reply = "error " + std::to_string(id) + " " + e.what() + "\n";
+			}
+
+			if (!channel.write(reply))
+				break;
+		}
+
+		close(fd);
+	}
+
+	/**
+	 * Reads the reply to task id. Returns false if the connection ends first; otherwise
+	 * either fills entries, sets unrealizable, or sets failure to the message of the worker.
+	 */
+	bool readReply(Channel& channel, size_t id, Vector<Set<BVar>>& entries, bool& unrealizable, string& failure)
+	{
+		string line;
+
+		if (!channel.readLine(line))
+			return false;
+
+		istringstream in(line);
+		string keyword;
+		size_t replyId, count;
+
+		if (!(in >> keyword >> replyId) || replyId != id)
+			throw runtime_error("Unexpected reply from a worker: " + line);
+
+		if (keyword == "error")
+		{
+			std::getline(in >> std::ws, failure);
+			return true;
+		}
+
+		if (keyword == "unrealizable")
+		{
+			unrealizable = true;
+			return true;
+		}
+
+		if (keyword != "result" || !(in >> count))
+			throw runtime_error("Unexpected reply from a worker: " + line);
+
+		for (size_t k = 0; k < count; k++)
+		{
+			if (!channel.readLine(line))
+				return false;
+
+			istringstream entry(line);
+			entries.push_back(readVars(entry));
+		}
+
+		return true;
+	}
+
+	/**
+	 * Checks an entry sent back for a task: it may only set indicators and outputs of the
+	 * task, and its outputs must satisfy Y_i of every indicator z_i it sets.
+	 */
+	void checkEntry(const Task& task, const Set<BVar>& entry)
+	{
+		Set<BVar> outputs;
+
+		for (const CNFClause& clause : task.outputClauses)
+			for (BLit lit : clause)
+				outputs.insert(abs(lit));
+
+		Set<BVar> assignment;
+		size_t indicatorCount = 0;
+
+		for (BVar var : entry)
+		{
+			if (outputs.count(var) > 0)
+				assignment.insert(var);
+			else if (std::find(task.indicators.begin(), task.indicators.end(), var) != task.indicators.end())
+				indicatorCount++;
+			else
+				throw runtime_error("Worker sent an entry with variable " + std::to_string(var) + " outside its task");
+		}
+
+		for (size_t i = 0; i < task.indicators.size() && indicatorCount > 0; i++)
+			if (entry.count(task.indicators[i]) > 0 && !task.outputClauses[i].eval(assignment))
+				throw runtime_error("Worker sent an entry violating Y_i of indicator " + std::to_string(task.indicators[i]));
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	for (int fd : _connections)
+		close(fd);
+
+	for (pid_t child : _children)
+		waitpid(child, nullptr, 0);
+}
+
+void WorkerPool::startLocal(size_t count, const SynthesisOptions& options)
+{
+	std::cout.flush(); /*< output still buffered would be written by every child too */
+
+	for (size_t k = 0; k < count; k++)
+	{
+		int ends[2];
+
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, ends) < 0)
+			throw runtime_error("Could not create a socket pair");
+
+		pid_t pid = fork();
+
+		if (pid < 0)
+			throw runtime_error("Could not start a worker process");
+
+		if (pid == 0)
+		{
+			for (int fd : _connections)
+				close(fd);
+
+			close(ends[0]);
+
+			try
+			{
+				serveCoordinator(ends[1], string(), options);
+			}
+			catch (...)
+			{
+				_exit(1);
+			}
+
+			_exit(0);
+		}
+
+		close(ends[1]);
+		_children.push_back(pid);
+
+		if (!greetWorker(ends[0], string()))
+		{
+			close(ends[0]);
+			throw runtime_error("Local worker did not start");
+		}
+
+		_connections.push_back(ends[0]);
+	}
+}
+
+void WorkerPool::acceptRemote(const string& bindAddress, uint16_t port, size_t count, const string& token)
+{
+	addrinfo hints;
+	std::memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_flags = AI_PASSIVE;
+
+	addrinfo* candidates;
+	string service = std::to_string(port);
+
+	if (getaddrinfo(bindAddress.c_str(), service.c_str(), &hints, &candidates) != 0)
+		throw runtime_error("Could not resolve " + bindAddress);
+
+	int server = -1;
+
+	for (addrinfo* candidate = candidates; candidate && server < 0; candidate = candidate->ai_next)
+	{
+		server = socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+
+		if (server < 0)
+			continue;
+
+		int reuse = 1;
+		setsockopt(server, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+		if (bind(server, candidate->ai_addr, candidate->ai_addrlen) < 0 || listen(server, SOMAXCONN) < 0)
+		{
+			close(server);
+			server = -1;
+		}
+	}
+
+	freeaddrinfo(candidates);
+
+	if (server < 0)
+		throw runtime_error("Could not listen on " + bindAddress + ":" + service);
+
+	for (size_t k = 0; k < count;)
+	{
+		int worker = accept(server, nullptr, nullptr);
+
+		if (worker >= 0)
+		{
+			/* Connections that are not workers of this version with the token do not count */
+			if (greetWorker(worker, token))
+			{
+				_connections.push_back(worker);
+				k++;
+			}
+			else
+			{
+				std::cerr << "Rejected a connection that is not a bafsyn worker of protocol version "
+				          << protocolVersion << " with the token" << std::endl;
+				close(worker);
+			}
+		}
+		else if (errno != EINTR && errno != ECONNABORTED)
+		{
+			close(server);
+			throw runtime_error("Could not accept workers on " + bindAddress + ":" + service);
+		}
+	}
+
+	close(server);
+}
+
+size_t WorkerPool::size() const
+{
+	return _connections.size();
+}
+
+Model WorkerPool::synthesize(const TrivialSpec& f1, const MSSSpec& f2, const SynthesisOptions& options)
+{
+	if (_connections.empty())
+		return BAFConnectedComponents(f1, f2, options);
+
+	const Vector<BVar>& indicatorVars = f2.indicatorVars();
+	const Vector<CNFClause>& outputClauses = f2.outputCNF().clauses();
+
+	Vector<CNFClause> negDefinitions;
+
+	f1.forEach([&] (BVar, const CNFClause& negDefinition)
+	{
+		negDefinitions.push_back(negDefinition);
+	});
+
+	size_t cubeVarCount = options.cubeVars;
+
+	/* As in cubeAndConquer, a few more cubes than workers so that the load is balanced */
+	if (cubeVarCount == 0)
+	{
+		while ((size_t(1) << cubeVarCount) < _connections.size())
+			cubeVarCount++;
+
+		cubeVarCount += 2;
+	}
+
+	Model model;
+	Vector<size_t> componentOf; /*< component of every task */
+	Vector<Task> tasks;
+
+	for (const Set<size_t>& indices : f2.outputCNF().dualGraph().connectedComponents())
+	{
+		Task task;
+		task.approximate = options.approximate;
+		task.coneSize = options.coneSize;
+
+		for (size_t i : indices)
+		{
+			task.indicators.push_back(indicatorVars[i]);
+			task.negDefinitions.push_back(negDefinitions[i]);
+			task.outputClauses.push_back(outputClauses[i]);
+		}
+
+		size_t componentId = model.addComponent(Set<BVar>(task.indicators.begin(), task.indicators.end()));
+
+		/* Not worth a round trip */
+		if (task.indicators.size() <= options.tinyComponentSize)
+		{
+			for (Set<BVar>& mss : solveTask(task, options))
+				model.addMSS(componentId, std::move(mss));
+
+			continue;
+		}
+
+		Vector<Cube> cubes;
+
+		/* Cubes are opt-in as in BAFConnectedComponents, and are tasks instead of threads here */
+		if (options.cubeWorkers > 1 && _connections.size() > 1 && task.indicators.size() >= options.cubeMinIndicators)
+			cubes = splitIntoCubes(task.indicators, TrivialSpec(task.indicators, task.negDefinitions).conflictGraph(),
+			                       cubeVarCount);
+
+		if (cubes.empty())
+		{
+			componentOf.push_back(componentId);
+			tasks.push_back(task);
+		}
+
+		for (const Cube& cube : cubes)
+		{
+			task.cube = cube;
+			componentOf.push_back(componentId);
+			tasks.push_back(task);
+		}
+	}
+
+	std::mutex mutex;
+	std::condition_variable changed; /*< signalled when a task is finished or given back */
+	std::deque<size_t> queue;
+	size_t inFlight = 0;
+	Vector<Vector<Set<BVar>>> results(tasks.size());
+	Vector<bool> finished(tasks.size(), false);
+	string failure; /*< first error reported by a worker */
+	bool unrealizable = false;
+
+	for (size_t t = 0; t < tasks.size(); t++)
+		queue.push_back(t);
+
+	/* One thread per worker, each sending it one task at a time */
+	auto serve = [&] (int fd)
+	{
+		Channel channel(fd);
+		std::unique_lock<std::mutex> lock(mutex);
+
+		for (;;)
+		{
+			/* A task in flight may still be given back by a lost worker */
+			changed.wait(lock, [&] { return !queue.empty() || inFlight == 0 || !failure.empty(); });
+
+			if (queue.empty() || !failure.empty())
+				return;
+
+			size_t t = queue.front();
+			queue.pop_front();
+			inFlight++;
+
+			/* Cubes of a component share the entries found so far, like the threads of cubeAndConquer */
+			if (tasks[t].cube)
+			{
+				tasks[t].known.clear();
+
+				for (size_t u = 0; u < tasks.size(); u++)
+					if (finished[u] && componentOf[u] == componentOf[t])
+						tasks[t].known.insert(tasks[t].known.end(), results[u].begin(), results[u].end());
+			}
+
+			string message = encodeTask(t, tasks[t]);
+
+			lock.unlock();
+
+			Vector<Set<BVar>> entries;
+			string error;
+			bool noMSS = false;
+			bool answered;
+
+			try
+			{
+				answered = channel.write(message) && readReply(channel, t, entries, noMSS, error);
+
+				for (const Set<BVar>& entry : entries)
+					checkEntry(tasks[t], entry);
+			}
+			catch (const std::exception& e)
+			{
+				answered = true;
+				error = e.what();
+			}
+
+			lock.lock();
+			inFlight--;
+
+			if (!answered)
+			{
+				/* The worker is lost, another one takes the task */
+				queue.push_front(t);
+				changed.notify_all();
+				return;
+			}
+
+			if (!error.empty() && failure.empty())
+				failure = error;
+
+			unrealizable |= noMSS;
+
+			results[t] = std::move(entries);
+			finished[t] = true;
+			changed.notify_all();
+		}
+	};
+
+	Vector<std::thread> threads;
+
+	for (int fd : _connections)
+		threads.emplace_back(serve, fd);
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	if (unrealizable)
+		throw Unrealizable();
+	if (!failure.empty())
+		throw runtime_error("Worker failed: " + failure);
+	if (!queue.empty())
+		throw runtime_error("No worker left to synthesize the remaining components");
+
+	/* Cubes of a component may find the same MSS, which is kept once */
+	Vector<Set<Set<BVar>>> added(model.componentCount());
+
+	for (size_t t = 0; t < results.size(); t++)
+		for (Set<BVar>& mss : results[t])
+			if (added[componentOf[t]].insert(mss).second)
+				model.addMSS(componentOf[t], std::move(mss));
+
+	return model;
+}
+
+void runWorker(const string& address, const string& token, const SynthesisOptions& options)
+{
+	size_t colon = address.rfind(':');
+
+	if (colon == string::npos)
+		throw std::invalid_argument("Expected host:port, got " + address);
+
+	string host = address.substr(0, colon);
+	string port = address.substr(colon + 1);
+
+	addrinfo hints;
+	std::memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+
+	addrinfo* candidates;
+
+	if (getaddrinfo(host.c_str(), port.c_str(), &hints, &candidates) != 0)
+		throw runtime_error("Could not resolve " + address);
+
+	int fd = -1;
+
+	for (addrinfo* candidate = candidates; candidate && fd < 0; candidate = candidate->ai_next)
+	{
+		fd = socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+
+		if (fd >= 0 && connect(fd, candidate->ai_addr, candidate->ai_addrlen) < 0)
+		{
+			close(fd);
+			fd = -1;
+		}
+	}
+
+	freeaddrinfo(candidates);
+
+	if (fd < 0)
+		throw runtime_error("Could not connect to " + address);
+
+	serveCoordinator(fd, token, options);
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "TrivialSpec.hpp"
+#include "MSSSpec.hpp"
+#include "Model.hpp"
+#include "SynthesisOptions.hpp"
+#include "Vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <sys/types.h>
+
+/**
+ * Distributed synthesis: a coordinator decomposes the specification and ships the
+ * components, or cubes of the large ones, to worker processes, which run the usual
+ * algorithm on them and send back their MSS lists.
+ *
+ * Workers are connected through stream sockets (TCP, or socket pairs for local workers)
+ * and speak a line-based text protocol. Literals and variables keep their numbers in the
+ * specification, and every list of them ends with 0 as in DIMACS.
+ *
+ * On connection, the worker sends "hello <version> <token>" and the coordinator answers with
+ * the same line; either side drops a connection whose hello is missing, of another version or
+ * with another token. The token is a secret shared by the coordinator and its remote workers
+ * (none for local workers, and the line is then "hello <version>"). It keeps other clients
+ * from submitting entries, but is sent in clear, so it does not protect against anyone able
+ * to read the traffic.
+ *
+ * Coordinator to worker, one task:
+ *
+ *     task <id> <n> <cubed> <k> <approximate> <cone size>
+ *     <z_i> <literals of X_i> 0 <literals of Y_i> 0      (n lines, one per definition)
+ *     cube <indicators in> 0 <indicators out> 0          (only if cubed is 1)
+ *     <true z and y variables of a known entry> 0        (k lines)
+ *
+ * Known entries are the entries already found for other cubes of the component; the
+ * worker only covers the MFS of the cube that they do not cover. The approximate flag and
+ * the cone size replace the options of the worker, since they decide whether entries are
+ * exact MSS.
+ *
+ * Worker to coordinator, the new entries covering the component (or the MFS of the cube):
+ *
+ *     result <id> <m>
+ *     <true z and y variables of the entry> 0            (m lines)
+ *
+ * or "unrealizable <id>" if some MFS has no MSS, or "error <id> <message>" if the task
+ * failed. A worker serves tasks one at a time until the coordinator closes the connection.
+ * Workers use their own synthesis options apart from those sent with the task. The
+ * coordinator checks that every entry only sets indicators and outputs of its task, and
+ * satisfies Y_i of every indicator it sets, but cannot check that the entries cover the
+ * component: workers must be trusted for that.
+ */
+
+/** Connections of a coordinator to its workers */
+class WorkerPool
+{
+	Vector<int> _connections;
+	Vector<pid_t> _children; /*< local workers */
+
+public:
+
+	WorkerPool() = default;
+
+	/** Closes the connections, which stops the workers, and waits for the local workers */
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	/**
+	 * Forks count worker processes connected through socket pairs, with the given options.
+	 * Must be called before the process starts any thread.
+	 */
+	void startLocal(size_t count, const SynthesisOptions& options);
+
+	/**
+	 * Listens on the TCP port of bindAddress until count workers (see runWorker) have
+	 * connected. Connections without the hello line of a worker with the token do not count.
+	 */
+	void acceptRemote(const std::string& bindAddress, uint16_t port, size_t count, const std::string& token);
+
+	size_t size() const;
+
+	/**
+	 * Version of BAFConnectedComponents running on the workers. Components with at most
+	 * options.tinyComponentSize indicators are solved locally. If options.cubeWorkers > 1,
+	 * components with at least options.cubeMinIndicators indicators are split into cubes
+	 * (options.cubeVars, or enough for the workers), one task each; every cube task carries
+	 * the entries already found for its component, and the lists of the cubes are
+	 * concatenated without duplicates. A task whose worker is lost is given to another
+	 * worker. Throws Unrealizable if the specification is unrealizable, and
+	 * std::runtime_error if a worker fails, sends an invalid entry or no worker is left.
+	 */
+	Model synthesize(const TrivialSpec& f1, const MSSSpec& f2, const SynthesisOptions& options);
+};
+
+/**
+ * Connects to the coordinator at host:port, presenting the token, and serves its tasks until
+ * it closes the connection.
+ */
+void runWorker(const std::string& address, const std::string& token, const SynthesisOptions& options);
@@ -74,8 +74,25 @@ public:
 			_edgeCount++;
 		}
 
+	/** Number of edges leaving the given vertex */
+	size_t degree(V v) const
+		{
+			return _neighbors[_indices.at(v)].size();
+		}
+
+	/** Returns the vertices adjacent to the given vertex */
+	Vector<V> neighbors(V v) const
+		{
+			Vector<V> result;
+
+			for (size_t j : _neighbors[_indices.at(v)])
+				result.push_back(_vertices[j]);
+
+			return result;
+		}
+
 	/* Returns true if an edge exists between the two vertices */
-	bool edgeExists(V from, V to)
+	bool edgeExists(V from, V to) const
 		{
 			size_t i = _indices.at(from);
 			size_t j = _indices.at(to);
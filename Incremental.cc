@@ -0,0 +1,170 @@
+#include "Incremental.hpp"
+
+#include <algorithm>
+#include <string>
+
+using std::string;
+
+namespace
+{
+	/** Content of every definition of the chain: sorted literals of X_i, then of Y_i */
+	Map<BVar, Vector<BLit>> definitionContents(const CNFChain& chain)
+	{
+		Map<BVar, Vector<BLit>> contents;
+
+		chain.first.forEach([&contents] (BVar z, const CNFClause& negDefinition)
+		{
+			Vector<BLit>& lits = contents[z];
+			lits.assign(negDefinition.begin(), negDefinition.end());
+			std::sort(lits.begin(), lits.end());
+			lits.push_back(0);
+		});
+
+		chain.second.forEach([&contents] (BVar z, const CNFClause& clause)
+		{
+			Vector<BLit>& lits = contents[z];
+			size_t start = lits.size();
+			lits.insert(lits.end(), clause.begin(), clause.end());
+			std::sort(lits.begin() + start, lits.end());
+		});
+
+		return contents;
+	}
+
+	string contentKey(const Vector<BLit>& lits)
+	{
+		return string(reinterpret_cast<const char*>(lits.data()), lits.size() * sizeof(BLit));
+	}
+}
+
+PreviousRun::PreviousRun(Model previous, const CNFChain& before, const CNFChain& after) : _model(std::move(previous))
+{
+	/* Previous indicators with every content, matched in the order of the definitions */
+	Map<string, Vector<BVar>> previousWith;
+
+	Map<BVar, Vector<BLit>> previousContents = definitionContents(before);
+
+	for (BVar z : before.second.indicatorVars())
+		previousWith[contentKey(previousContents.at(z))].push_back(z);
+
+	for (auto& candidates : previousWith)
+		std::reverse(candidates.second.begin(), candidates.second.end());
+
+	Map<BVar, Vector<BLit>> currentContents = definitionContents(after);
+
+	for (BVar z : after.second.indicatorVars())
+	{
+		auto candidates = previousWith.find(contentKey(currentContents.at(z)));
+
+		if (candidates != previousWith.end() && !candidates->second.empty())
+		{
+			_previousOf[z] = candidates->second.back();
+			candidates->second.pop_back();
+		}
+	}
+
+	for (size_t c = 0; c < _model.componentCount(); c++)
+		for (BVar z : _model.allComponents()[c])
+			_componentOf[z] = c;
+}
+
+Optional<Vector<Set<BVar>>> PreviousRun::unchangedList(const Vector<BVar>& indicators) const
+{
+	Map<BVar, BVar> currentOf;
+	Optional<size_t> component;
+
+	for (BVar z : indicators)
+	{
+		auto previous = _previousOf.find(z);
+
+		if (previous == _previousOf.end())
+			return nullopt;
+
+		auto c = _componentOf.find(previous->second);
+
+		if (c == _componentOf.end() || (component && *component != c->second))
+			return nullopt;
+
+		component = c->second;
+		currentOf[previous->second] = z;
+	}
+
+	if (!component || _model.allComponents()[*component].size() != indicators.size())
+		return nullopt;
+
+	/* Outputs are not renumbered */
+	Vector<Set<BVar>> entries;
+
+	for (const Set<BVar>& entry : _model.mssForComponent(*component))
+	{
+		Set<BVar> renamed;
+
+		for (BVar var : entry)
+		{
+			auto current = currentOf.find(var);
+			renamed.insert((current != currentOf.end()) ? current->second : var);
+		}
+
+		entries.push_back(std::move(renamed));
+	}
+
+	_unchanged++;
+	return entries;
+}
+
+Vector<Set<BVar>> PreviousRun::seeds(const Vector<BVar>& indicators, const Vector<CNFClause>& clauses) const
+{
+	Set<size_t> components;
+	Set<BVar> outputs;
+
+	for (size_t i = 0; i < indicators.size(); i++)
+	{
+		auto previous = _previousOf.find(indicators[i]);
+
+		if (previous != _previousOf.end())
+		{
+			auto c = _componentOf.find(previous->second);
+
+			if (c != _componentOf.end())
+				components.insert(c->second);
+		}
+
+		for (BLit lit : clauses[i])
+			outputs.insert(abs(lit));
+	}
+
+	Set<Set<BVar>> found;
+	Vector<Set<BVar>> seeds;
+
+	for (size_t c : components)
+		for (const Set<BVar>& entry : _model.mssForComponent(c))
+		{
+			Set<BVar> seed;
+
+			for (BVar var : entry)
+				if (outputs.count(var) > 0)
+					seed.insert(var);
+
+			Set<BVar> assignment = seed;
+
+			for (size_t i = 0; i < indicators.size(); i++)
+				if (clauses[i].eval(assignment))
+					seed.insert(indicators[i]);
+
+			if (seed.size() > assignment.size() && found.insert(seed).second)
+				seeds.push_back(std::move(seed));
+		}
+
+	_seeds += seeds.size();
+	return seeds;
+}
+
+size_t PreviousRun::unchangedCount() const
+{
+	return _unchanged;
+}
+
+size_t PreviousRun::seedCount() const
+{
+	return _seeds;
+}
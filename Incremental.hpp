@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CNFChain.hpp"
+#include "Model.hpp"
+#include "Map.hpp"
+#include "Optional.hpp"
+#include "Set.hpp"
+#include "Vector.hpp"
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Lists of a run on an earlier version of a specification, translated to the definitions of
+ * the current version for incremental re-synthesis.
+ *
+ * Definitions are matched by content: a current definition is the same as a previous one when
+ * both have the same X_i and Y_i (indicators are numbered by the decomposition, so an edit
+ * renumbers them). A component whose definitions are exactly those of one previous component
+ * has the same conflict graph and output clauses, so it is unchanged and its previous list is
+ * reused, renamed. The other components are seeded with the previous entries that are still
+ * valid: the outputs of an entry of a previous component sharing definitions with the
+ * component, restricted to the outputs of the component, with every indicator of the component
+ * whose Y_i they satisfy. Seeds are maximal for their outputs, but need not be MSS, and the
+ * back-and-forth loop only keeps those covering an MFS that the seeds before them do not.
+ */
+class PreviousRun
+{
+	Model _model;
+	Map<BVar, BVar> _previousOf; /*< previous indicator of every matched current indicator */
+	Map<BVar, size_t> _componentOf; /*< previous component of every previous indicator */
+
+	mutable std::atomic<size_t> _unchanged { 0 };
+	mutable std::atomic<size_t> _seeds { 0 };
+
+public:
+
+	/** previous is the model synthesized for before (see MappedModel::toModel) */
+	PreviousRun(Model previous, const CNFChain& before, const CNFChain& after);
+
+	PreviousRun(const PreviousRun&) = delete;
+	PreviousRun& operator=(const PreviousRun&) = delete;
+
+	/** Previous list of the current component with the given indicators, renamed, if it is unchanged */
+	Optional<Vector<Set<BVar>>> unchangedList(const Vector<BVar>& indicators) const;
+
+	/** Still-valid previous entries for a changed component (indicators[i] has output clause clauses[i]) */
+	Vector<Set<BVar>> seeds(const Vector<BVar>& indicators, const Vector<CNFClause>& clauses) const;
+
+	/** Components reused so far, and seeds offered so far (kept or not) */
+	size_t unchangedCount() const;
+	size_t seedCount() const;
+};
@@ -0,0 +1,216 @@
+#include "Isomorphism.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+using std::string;
+
+namespace
+{
+	/** Labels of the edges of the component graph */
+	enum EdgeLabel : uint32_t
+	{
+		Conflict,
+		Positive,
+		Negative
+	};
+
+	struct Edge
+	{
+		uint32_t label;
+		uint32_t target;
+	};
+
+	size_t distinctCount(Vector<uint32_t> values)
+	{
+		std::sort(values.begin(), values.end());
+		return std::unique(values.begin(), values.end()) - values.begin();
+	}
+
+	/**
+	 * Refines the coloring until it is stable, and returns the number of colors. The new color
+	 * of a vertex is the rank of its signature (its color, then the sorted labels and colors of
+	 * its neighbors), so colors only depend on the structure, and the order of the old colors
+	 * is kept.
+	 */
+	size_t refine(const Vector<Vector<Edge>>& adjacency, Vector<uint32_t>& color)
+	{
+		size_t n = color.size();
+		size_t colorCount = distinctCount(color);
+
+		Vector<Vector<uint64_t>> signature(n);
+		Vector<size_t> order(n);
+
+		for (;;)
+		{
+			for (size_t v = 0; v < n; v++)
+			{
+				signature[v].clear();
+
+				for (const Edge& edge : adjacency[v])
+					signature[v].push_back((uint64_t(edge.label) << 32) | color[edge.target]);
+
+				std::sort(signature[v].begin(), signature[v].end());
+				signature[v].insert(signature[v].begin(), color[v]);
+			}
+
+			std::iota(order.begin(), order.end(), 0);
+			std::sort(order.begin(), order.end(),
+			          [&signature] (size_t a, size_t b) { return signature[a] < signature[b]; });
+
+			uint32_t rank = 0;
+
+			for (size_t k = 0; k < n; k++)
+			{
+				if (k > 0 && signature[order[k]] != signature[order[k - 1]])
+					rank++;
+
+				color[order[k]] = rank;
+			}
+
+			size_t refinedCount = (n > 0) ? rank + 1 : 0;
+
+			/* Refinement only splits classes, so the same count means the same partition */
+			if (refinedCount == colorCount)
+				return colorCount;
+
+			colorCount = refinedCount;
+		}
+	}
+}
+
+CanonicalComponent canonicalComponent(const Vector<BVar>& indicators,
+                                      const Vector<CNFClause>& clauses,
+                                      const Graph<size_t>& conflictGraph)
+{
+	size_t k = indicators.size();
+
+	/* Vertices 0, ..., k - 1 are the definitions, the outputs follow */
+	Map<BVar, uint32_t> outputVertex;
+	Vector<BVar> outputs;
+
+	for (const CNFClause& clause : clauses)
+		for (BLit lit : clause)
+			if (outputVertex.emplace(abs(lit), k + outputs.size()).second)
+				outputs.push_back(abs(lit));
+
+	size_t n = k + outputs.size();
+
+	Map<size_t, uint32_t> definitionVertex;
+
+	for (size_t i = 0; i < k; i++)
+		definitionVertex[conflictGraph.vertexByIndex(i)] = i;
+
+	Vector<Vector<Edge>> adjacency(n);
+
+	for (size_t i = 0; i < k; i++)
+	{
+		for (size_t neighbor : conflictGraph.neighbors(conflictGraph.vertexByIndex(i)))
+			adjacency[i].push_back({ Conflict, definitionVertex.at(neighbor) });
+
+		for (BLit lit : clauses[i])
+		{
+			uint32_t label = (lit > 0) ? Positive : Negative;
+			uint32_t output = outputVertex.at(abs(lit));
+
+			adjacency[i].push_back({ label, output });
+			adjacency[output].push_back({ label, uint32_t(i) });
+		}
+	}
+
+	/* Definitions start with a smaller color than outputs, so they keep the first positions */
+	Vector<uint32_t> color(n, 0);
+
+	for (size_t v = k; v < n; v++)
+		color[v] = 1;
+
+	size_t colorCount = refine(adjacency, color);
+
+	while (colorCount < n)
+	{
+		Vector<size_t> classSize(colorCount, 0);
+
+		for (size_t v = 0; v < n; v++)
+			classSize[color[v]]++;
+
+		uint32_t shared = std::find_if(classSize.begin(), classSize.end(),
+		                               [] (size_t size) { return size > 1; }) - classSize.begin();
+		size_t chosen = std::find(color.begin(), color.end(), shared) - color.begin();
+
+		/* The chosen vertex goes before the rest of its class */
+		for (size_t v = 0; v < n; v++)
+			color[v] = 2 * color[v] + ((color[v] == shared && v != chosen) ? 1 : 0);
+
+		colorCount = refine(adjacency, color);
+	}
+
+	/* Colors are now the canonical positions */
+	CanonicalComponent canon;
+	canon.indicators.resize(k);
+	canon.outputs.resize(n - k);
+
+	Vector<size_t> vertexAt(n);
+
+	for (size_t v = 0; v < n; v++)
+	{
+		vertexAt[color[v]] = v;
+
+		if (v < k)
+			canon.indicators[color[v]] = indicators[v];
+		else
+			canon.outputs[color[v] - k] = outputs[v - k];
+	}
+
+	/* For every definition by position: its conflicts, then the literals of Y_i (2 * position + sign) */
+	Vector<uint32_t> words { uint32_t(k), uint32_t(n - k) };
+
+	for (size_t p = 0; p < k; p++)
+	{
+		Vector<uint32_t> conflicts;
+		Vector<uint32_t> lits;
+
+		for (const Edge& edge : adjacency[vertexAt[p]])
+		{
+			if (edge.label == Conflict)
+				conflicts.push_back(color[edge.target]);
+			else
+				lits.push_back(2 * (color[edge.target] - k) + ((edge.label == Negative) ? 1 : 0));
+		}
+
+		std::sort(conflicts.begin(), conflicts.end());
+		std::sort(lits.begin(), lits.end());
+
+		words.push_back(conflicts.size());
+		words.insert(words.end(), conflicts.begin(), conflicts.end());
+		words.push_back(lits.size());
+		words.insert(words.end(), lits.begin(), lits.end());
+	}
+
+	canon.key.assign(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(uint32_t));
+
+	return canon;
+}
+
+Map<BVar, BVar> componentRenaming(const CanonicalComponent& from, const CanonicalComponent& to)
+{
+	Map<BVar, BVar> renaming;
+
+	for (size_t p = 0; p < from.indicators.size(); p++)
+		renaming[from.indicators[p]] = to.indicators[p];
+
+	for (size_t p = 0; p < from.outputs.size(); p++)
+		renaming[from.outputs[p]] = to.outputs[p];
+
+	return renaming;
+}
+
+Set<BVar> renameEntry(const Set<BVar>& entry, const Map<BVar, BVar>& renaming)
+{
+	Set<BVar> renamed;
+
+	for (BVar var : entry)
+		renamed.insert(renaming.at(var));
+
+	return renamed;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CNFFormula.hpp"
+#include "Graph.hpp"
+#include "Map.hpp"
+#include "Set.hpp"
+#include "Vector.hpp"
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Canonical form of a component, used to find components that are identical up to
+ * renaming of their indicators and outputs.
+ *
+ * The list of a component only depends on the conflict graph of its definitions (whose
+ * maximal independent sets are the MFS) and on its output clauses Y_i, so the form is
+ * computed on the graph with one vertex per definition and one per output: conflict edges
+ * between definitions, and an edge labeled with the polarity between a definition and every
+ * output of Y_i. Vertices are ordered by color refinement, breaking the remaining ties by
+ * individualizing the first vertex of the first non-singleton class and refining again.
+ *
+ * Tie breaking is not canonical for every graph, so isomorphic components may get different
+ * keys, which only loses reuse. Equal keys always mean that the renaming pairing vertices at
+ * the same position is an isomorphism, since the key encodes the whole relabeled component.
+ */
+struct CanonicalComponent
+{
+	std::string key; /*< component relabeled by canonical positions */
+	Vector<BVar> indicators; /*< indicator of every canonical position */
+	Vector<BVar> outputs; /*< output of every canonical position */
+};
+
+/**
+ * Canonical form of the component with the given indicators, output clauses (clauses[i]
+ * is Y_i of indicators[i]) and conflict graph (vertex i is definition i).
+ */
+CanonicalComponent canonicalComponent(const Vector<BVar>& indicators,
+                                      const Vector<CNFClause>& clauses,
+                                      const Graph<size_t>& conflictGraph);
+
+/**
+ * Renaming of the indicators and outputs of the component with form 'from' to those of
+ * the component with form 'to', which must have the same key.
+ */
+Map<BVar, BVar> componentRenaming(const CanonicalComponent& from, const CanonicalComponent& to);
+
+/** Renames every variable of an entry, which must all be renamed */
+Set<BVar> renameEntry(const Set<BVar>& entry, const Map<BVar, BVar>& renaming);
@@ -0,0 +1,204 @@
+#include "ListMinimization.hpp"
+#include "MFSGenerator.hpp"
+#include "Map.hpp"
+#include "open-wbo/MaxSATFormula.h"
+#include "open-wbo/algorithms/Alg_WBO.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <tuple>
+
+using Glucose::vec;
+using Glucose::Lit;
+using Glucose::mkLit;
+
+namespace
+{
+	/**
+	 * Enumerates the MFS of the component, returning for each of them the positions of
+	 * the MSS covering it, or nothing if there are more than mfsLimit MFS.
+	 */
+	Optional<Vector<Vector<size_t>>> coveringMSS(const Vector<Set<BVar>>& mssList,
+	                                             const Set<BVar>& component,
+	                                             const Vector<BVar>& indicatorVars,
+	                                             const Graph<size_t>& conflictGraph,
+	                                             size_t mfsLimit)
+	{
+		MFSGenerator mfsGen(component, indicatorVars, conflictGraph);
+
+		Vector<Vector<size_t>> coveredBy;
+
+		while (Optional<Set<BVar>> mfs = mfsGen.newMFS())
+		{
+			if (coveredBy.size() == mfsLimit)
+				return nullopt;
+
+			Vector<size_t> covering;
+
+			for (size_t j = 0; j < mssList.size(); j++)
+				if (isSubset(*mfs, mssList[j]))
+					covering.push_back(j);
+
+			if (covering.empty())
+				throw std::invalid_argument("MSS list does not cover every MFS");
+
+			coveredBy.push_back(covering);
+
+			/* Blocking the MFS as if it were an MSS blocks exactly this MFS */
+			mfsGen.blockMSS(*mfs);
+		}
+
+		return coveredBy;
+	}
+
+	/**
+	 * Drops MSS, first to last, when every independent set of the conflict graph
+	 * inside them is inside another MSS still in the list. An independent set inside
+	 * MSS j and outside every other MSS is found by one SAT call, where the clause
+	 * "some indicator outside MSS k" is enabled for every other MSS k by an assumption.
+	 */
+	Vector<bool> irredundantCover(const Vector<Set<BVar>>& mssList,
+	                              const Vector<size_t>& vertices,
+	                              const Vector<BVar>& indicatorVars,
+	                              const Graph<size_t>& conflictGraph)
+	{
+		Glucose::Solver solver;
+		solver.setIncrementalMode();
+
+		Map<size_t, int> local; /*< solver variable of every vertex */
+
+		for (size_t v : vertices)
+			local[v] = solver.newVar();
+
+		for (const std::tuple<size_t, size_t>& edge : conflictGraph.edges())
+			solver.addClause(~mkLit(local.at(std::get<0>(edge))), ~mkLit(local.at(std::get<1>(edge))));
+
+		Vector<Lit> enabled; /*< enabled[k] activates the clause of MSS k */
+
+		for (const Set<BVar>& mss : mssList)
+		{
+			Lit activation = mkLit(solver.newVar());
+			vec<Lit> outside;
+			outside.push(~activation);
+
+			for (size_t v : vertices)
+				if (mss.find(indicatorVars[v]) == mss.end())
+					outside.push(mkLit(local.at(v)));
+
+			solver.addClause(outside);
+			enabled.push_back(activation);
+		}
+
+		Vector<bool> kept(mssList.size(), true);
+
+		for (size_t j = 0; j < mssList.size(); j++)
+		{
+			vec<Lit> assumptions;
+
+			for (size_t k = 0; k < mssList.size(); k++)
+				if (k != j && kept[k])
+					assumptions.push(enabled[k]);
+
+			/* Search inside MSS j */
+			for (size_t v : vertices)
+				if (mssList[j].find(indicatorVars[v]) == mssList[j].end())
+					assumptions.push(~mkLit(local.at(v)));
+
+			/* No independent set is only covered by MSS j */
+			if (!solver.solve(assumptions))
+				kept[j] = false;
+		}
+
+		return kept;
+	}
+
+	/**
+	 * Minimum set cover as MaxSAT: variable j selects MSS j, every MFS requires one of
+	 * the MSS covering it (hard), and every selected MSS costs one (soft).
+	 */
+	Vector<bool> exactCover(const Vector<Vector<size_t>>& coveredBy, size_t mssCount)
+	{
+		openwbo::MaxSATFormula* formula = new openwbo::MaxSATFormula();
+
+		formula->setHardWeight(coveredBy.size() + mssCount + 1);
+
+		for (size_t j = 0; j < mssCount; j++)
+			formula->newVar();
+
+		for (const Vector<size_t>& covering : coveredBy)
+		{
+			vec<Lit> lits;
+
+			for (size_t j : covering)
+				lits.push(mkLit(j));
+
+			formula->addHardClause(lits);
+		}
+
+		for (size_t j = 0; j < mssCount; j++)
+		{
+			vec<Lit> lits;
+			lits.push(~mkLit(j));
+
+			formula->setMaximumWeight(1);
+			formula->updateSumWeights(1);
+			formula->addSoftClause(1, lits);
+		}
+
+		formula->setProblemType(_UNWEIGHTED_);
+		formula->setFormat(_FORMAT_MAXSAT_);
+
+		openwbo::WBO solver;
+		solver.loadFormula(formula); /*< takes ownership of the formula */
+
+		if (!solver.search())
+			throw std::logic_error("Set cover of the MFS is infeasible");
+
+		Vector<bool> kept(mssCount);
+
+		for (size_t j = 0; j < mssCount; j++)
+			kept[j] = (solver.getModel()[j] == l_True);
+
+		return kept;
+	}
+}
+
+Vector<Set<BVar>> minimizeMSSList(const Vector<Set<BVar>>& mssList,
+                                  const Vector<BVar>& indicatorVars,
+                                  const Graph<size_t>& conflictGraph,
+                                  size_t mfsLimit,
+                                  size_t exactLimit)
+{
+	if (mssList.size() <= 1)
+		return mssList;
+
+	Vector<size_t> vertices;
+	Set<BVar> component;
+
+	for (size_t i = 0; i < conflictGraph.size(); i++)
+	{
+		vertices.push_back(conflictGraph.vertexByIndex(i));
+		component.insert(indicatorVars[vertices.back()]);
+	}
+
+	Vector<bool> kept = irredundantCover(mssList, vertices, indicatorVars, conflictGraph);
+
+	size_t keptCount = std::count(kept.begin(), kept.end(), true);
+
+	/* An irredundant list may still not be the shortest one */
+	if (keptCount > 1 && keptCount <= exactLimit)
+	{
+		Optional<Vector<Vector<size_t>>> coveredBy = coveringMSS(mssList, component, indicatorVars, conflictGraph, mfsLimit);
+
+		if (coveredBy)
+			kept = exactCover(*coveredBy, mssList.size());
+	}
+
+	Vector<Set<BVar>> result;
+
+	for (size_t j = 0; j < mssList.size(); j++)
+		if (kept[j])
+			result.push_back(mssList[j]);
+
+	return result;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "CNFFormula.hpp"
+#include "Graph.hpp"
+#include "Set.hpp"
+#include "Vector.hpp"
+
+/**
+ * Removes redundant MSS from the list of a component.
+ *
+ * - mssList: MSS of the component, covering every MFS.
+ * - indicatorVars: indicator variables across all components by index.
+ * - conflictGraph: conflict graph of the component, over indices into indicatorVars.
+ * - mfsLimit: maximum number of MFS enumerated for exact minimization.
+ * - exactLimit: maximum length of an irredundant list for exact minimization.
+ *
+ * The list is first made irredundant: every MSS, first to last, is dropped if every
+ * independent set of the conflict graph it contains is contained in another MSS still
+ * in the list, which takes one SAT call per MSS. If at most exactLimit MSS remain and
+ * the component has at most mfsLimit MFS, a minimum cover of the MFS is then computed
+ * by a MaxSAT solver. The MSS that are kept stay in their original order, and every
+ * input stays covered.
+ */
+Vector<Set<BVar>> minimizeMSSList(const Vector<Set<BVar>>& mssList,
+                                  const Vector<BVar>& indicatorVars,
+                                  const Graph<size_t>& conflictGraph,
+                                  size_t mfsLimit,
+                                  size_t exactLimit);
@@ -47,10 +47,23 @@ MFSGenerator::MFSGenerator(Set<BVar> relevantIndicators,
 
 Optional<Set<BVar>> MFSGenerator::newMFS()
 {
+	return newMFS(Set<BVar>(), Set<BVar>());
+}
+
+Optional<Set<BVar>> MFSGenerator::newMFS(const Set<BVar>& inCube, const Set<BVar>& outOfCube)
+{
+	vec<Lit> assumptions;
+
+	for (BVar v : inCube)
+		assumptions.push(mkLit(_index.at(v)));
+
+	for (BVar v : outOfCube)
+		assumptions.push(~mkLit(_index.at(v)));
+
   auto start = system_clock::now();
 
 	/* Solver returned SAT, a falsifiable set was found */
-	if (_satSolver.solve())
+	if (_satSolver.solve(assumptions))
 	{	
 	  auto time = duration_cast<milliseconds>(system_clock::now() - start);
 
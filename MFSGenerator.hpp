@@ -29,6 +29,13 @@ public:
 
 	/** Generates a new MFS, or nothing if there are no MFS left */
 	Optional<Set<BVar>> newMFS();
+
+	/**
+	 * Generates a new MFS in the cube where the indicators in inCube are part of
+	 * the MFS and the ones in outOfCube are not, or nothing if the cube has no MFS left.
+	 * The MFS is still extended to a maximal one, so it may leave the cube.
+	 */
+	Optional<Set<BVar>> newMFS(const Set<BVar>& inCube, const Set<BVar>& outOfCube);
 	
 	/** Block an MSS such that future MFS will not be contained in it */
 	void blockMSS(const Set<BVar>& mss);
@@ -4,9 +4,6 @@
 #include <limits>
 
 using openwbo::MaxSATFormula;
-using NSPACE::IntRange;
-using NSPACE::IntOption;
-using NSPACE::BoolOption;
 
 #include <chrono>
 #include <iostream>
@@ -17,23 +14,6 @@ using std::chrono::milliseconds;
 using std::cout;
 using std::endl;
 
-/**
- * Solver options copied from open-wbo.
- */
-const IntOption verbosity("Open-WBO", "verbosity",
-			  "Verbosity level (0=minimal, 1=more).\n", 0,
-			  IntRange(0, 1));
-
-const IntOption weight("WBO", "weight-strategy",
-		       "Weight strategy (0=none, 1=weight-based, 2=diversity-based).\n", 2,
-		       IntRange(0, 2));
-
-const BoolOption symmetry("WBO", "symmetry", "Symmetry breaking.\n", true);
-
-const IntOption symmetry_lim("WBO", "symmetry-limit",
-			     "Limit on the number of symmetry breaking clauses.\n", 500000,
-			     IntRange(0, INT32_MAX));
-
 /**
  * Add soft clause with the given weight to the formula.
  */
@@ -111,9 +91,25 @@ void addHardClauseWithIndicator(MaxSATFormula* formula,
 
 MSSGenerator::MSSGenerator(Set<BVar> indicatorVarSet,
 			   const Vector<BVar>& indicators,
-			   const Vector<CNFClause>& clauses)
+			   const Vector<CNFClause>& clauses,
+			   bool detectStructure,
+			   bool approximateMode,
+			   const MaxSATOptions& maxsat)
   : allIndicatorVars(indicatorVarSet)
+  , indicatorList(indicators)
+  , maxsatOptions(maxsat)
 {
+  if (detectStructure)
+  {
+    ClauseStructure structure = classifyClauses(clauses);
+
+    if (structure != ClauseStructure::General)
+      structured.emplace(structure, indicators, clauses);
+  }
+
+  if (approximateMode && !structured)
+    approximate.reset(new ApproximateMSS(indicators, clauses));
+
   /* Set weight for hard clauses to the maximum possible value */
   uint64_t hardWeight = std::numeric_limits<uint64_t>::max();
   maxSatFormula.setHardWeight(hardWeight);
@@ -158,7 +154,8 @@ Set<BVar> variablesSetToTrue(const vec<lbool>& model)
 
 Optional<Set<BVar>> MSSGenerator::newMSS()
 {
-  openwbo::WBO maxSatSolver(verbosity, weight, symmetry, symmetry_lim);
+  openwbo::WBO maxSatSolver(maxsatOptions.verbosity, maxsatOptions.weightStrategy,
+			    maxsatOptions.symmetry, maxsatOptions.symmetryLimit);
 
   maxSatSolver.loadFormula(maxSatFormula.copyMaxSATFormula());
 
@@ -175,18 +172,49 @@ Optional<Set<BVar>> MSSGenerator::newMSS()
   }
 }
 
-Optional<Set<BVar>> MSSGenerator::newMSSCovering(const Set<BVar>& vars)
+MaxSATFormula* MSSGenerator::weightedCopy(const Map<BVar, uint64_t>& weights)
 {
-  openwbo::WBO maxSatSolver(verbosity, weight, symmetry, symmetry_lim);
+  MaxSATFormula* copy = new MaxSATFormula();
 
-  /* Create copy of the formula */
-  MaxSATFormula* copy = maxSatFormula.copyMaxSATFormula();
+  /* Hard weight must be set first, so that soft weights are not mistaken for it */
+  copy->setHardWeight(maxSatFormula.getHardWeight());
+  copy->setInitialVars(maxSatFormula.nVars());
+
+  for (int i = 0; i < maxSatFormula.nVars(); i++)
+    copy->newVar();
+
+  /* Soft clauses were added in the same order as the indicator variables */
+  for (int i = 0; i < maxSatFormula.nSoft(); i++)
+  {
+    auto it = weights.find(indicatorList[i]);
+    uint64_t w = (it != weights.end()) ? it->second : 1;
+
+    copy->setMaximumWeight(w);
+    copy->updateSumWeights(w);
+    copy->addSoftClause(w, maxSatFormula.getSoftClause(i).clause);
+  }
+
+  for (int i = 0; i < maxSatFormula.nHard(); i++)
+    copy->addHardClause(maxSatFormula.getHardClause(i).clause);
+
+  copy->setProblemType(_WEIGHTED_);
+  copy->setFormat(_FORMAT_MAXSAT_);
+
+  return copy;
+}
+
+Optional<Set<BVar>> MSSGenerator::searchCovering(MaxSATFormula* formula,
+						 const Set<BVar>& vars,
+						 int weightStrategy)
+{
+  openwbo::WBO maxSatSolver(maxsatOptions.verbosity, weightStrategy,
+			    maxsatOptions.symmetry, maxsatOptions.symmetryLimit);
 
   /* Add constraints enforcing that result covers the given set */
   for (BVar var : vars)
-    addHardClause(copy, CNFClause(var));
+    addHardClause(formula, CNFClause(var));
 
-  maxSatSolver.loadFormula(copy);
+  maxSatSolver.loadFormula(formula);
 
   auto start = system_clock::now();
 
@@ -210,3 +238,54 @@ Optional<Set<BVar>> MSSGenerator::newMSSCovering(const Set<BVar>& vars)
     return nullopt;
   }
 }
+
+Optional<Set<BVar>> MSSGenerator::newMSSCovering(const Set<BVar>& vars)
+{
+  if (structured)
+  {
+    Optional<Set<BVar>> mss = structured->newMSSCovering(vars);
+
+    if (mss)
+      blockMSS(*mss);
+
+    return mss;
+  }
+
+  if (approximate)
+  {
+    Optional<Set<BVar>> mss = approximate->newSetCovering(vars);
+
+    if (mss)
+      blockMSS(*mss);
+
+    return mss;
+  }
+
+  /* Create copy of the formula */
+  return searchCovering(maxSatFormula.copyMaxSATFormula(), vars, maxsatOptions.weightStrategy);
+}
+
+Optional<Set<BVar>> MSSGenerator::newMSSCovering(const Set<BVar>& vars,
+						 const Map<BVar, uint64_t>& weights)
+{
+  if (structured)
+  {
+    Optional<Set<BVar>> mss = structured->newMSSCovering(vars, weights);
+
+    if (mss)
+      blockMSS(*mss);
+
+    return mss;
+  }
+
+  /* The approximate engine has no notion of weights */
+  if (approximate)
+    return newMSSCovering(vars);
+
+  /*
+   * The stratified weight strategies never lower the current weight with this
+   * version of the formula (setMaximumWeight only increases it), so they do not
+   * terminate on weighted formulas. The plain WBO search handles weights directly.
+   */
+  return searchCovering(weightedCopy(weights), vars, _WEIGHT_NONE_);
+}
@@ -3,10 +3,16 @@
 #include "CNFFormula.hpp"
 #include "Set.hpp"
 #include "Vector.hpp"
+#include "Map.hpp"
 #include "Optional.hpp"
+#include "StructuredMSS.hpp"
+#include "ApproximateMSS.hpp"
+#include "SynthesisOptions.hpp"
 #include "open-wbo/MaxSATFormula.h"
 #include "open-wbo/algorithms/Alg_WBO.h"
 
+#include <memory>
+
 /**
  * Class that generates Maximal Satisfiable Subsets using a MaxSAT solver.
  */
@@ -16,6 +22,15 @@ class MSSGenerator
   //openwbo::WBO maxSatSolver; /**< MaxSAT solver used for generating the MSS */
 
   Set<BVar> allIndicatorVars;
+  Vector<BVar> indicatorList; /**< indicatorList[i] is the variable of the i-th soft clause */
+
+  MaxSATOptions maxsatOptions; /**< parameters of every MaxSAT call */
+
+  /** Polynomial engine used instead of MaxSAT when the clauses are 2-CNF or Horn */
+  Optional<StructuredMSS> structured;
+
+  /** Single-SAT-call engine used instead of MaxSAT in approximate mode (results may not be maximal) */
+  std::unique_ptr<ApproximateMSS> approximate;
 
   /** Add hard clause */
   void enforceClause(const CNFClause& clause);
@@ -23,11 +38,30 @@ class MSSGenerator
   /** Add hard clause blocking given MSS */
   void blockMSS(const Set<BVar>& mss);
 
+  /** Create copy of the formula where the soft clause (z) has weight weights[z] */
+  openwbo::MaxSATFormula* weightedCopy(const Map<BVar, uint64_t>& weights);
+
+  /** Search for an MSS of the given formula containing the given variables (takes ownership of the formula) */
+  Optional<Set<BVar>> searchCovering(openwbo::MaxSATFormula* formula,
+				     const Set<BVar>& vars,
+				     int weightStrategy);
+
 public:
 
+  /**
+   * Constructs a generator for the clauses (z_i -> Y_i), where z_i = indicators[i] and Y_i = clauses[i].
+   * If detectStructure is set and the Y_i are 2-CNF or Horn, MSS covering a set are
+   * computed by a polynomial algorithm instead of the MaxSAT solver.
+   * If approximateMode is set, the remaining sets covering a given set are computed by a
+   * single SAT call instead of the MaxSAT solver, and are satisfiable but not always maximal.
+   * The MaxSAT solver is configured by maxsat.
+   */
   MSSGenerator(Set<BVar> indicatorVarSet,
 	       const Vector<BVar>& indicators,
-	       const Vector<CNFClause>& clauses);
+	       const Vector<CNFClause>& clauses,
+	       bool detectStructure = false,
+	       bool approximateMode = false,
+	       const MaxSATOptions& maxsat = MaxSATOptions());
 
   /**
    * Generate new MSS, or nothing if there are no MSS left.
@@ -37,4 +71,12 @@ public:
 
   /** Generate new MSS containing the given variables, or nothing if there are no MSS left */
   Optional<Set<BVar>> newMSSCovering(const Set<BVar>& vars);
+
+  /**
+   * Same as the above, but among the MSS containing the given variables
+   * prefers those maximizing the total weight of the indicators they contain.
+   * Every indicator must have positive weight, so that the result is still maximal.
+   */
+  Optional<Set<BVar>> newMSSCovering(const Set<BVar>& vars,
+				     const Map<BVar, uint64_t>& weights);
 };
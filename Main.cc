@@ -3,25 +3,341 @@
 #include "Algorithm.hpp"
 #include "Printing.hpp"
 #include "Verifier.hpp"
+#include "CompiledModel.hpp"
+#include "Profiling.hpp"
+#include "CodeGenerator.hpp"
+#include "AIG.hpp"
+#include "ModelFile.hpp"
+#include "SynthesisOptions.hpp"
+#include "TinyComponent.hpp"
+#include "ConeEnumeration.hpp"
+#include "BatchRunner.hpp"
+#include "Distributed.hpp"
+#include "ComponentCache.hpp"
+#include "Incremental.hpp"
+#include "Checkpoint.hpp"
+#include "utils/Options.h"
 
+#include <atomic>
 #include <chrono>
+#include <csignal>
+#include <fstream>
+#include <stdexcept>
 #include <iostream>
+#include <memory>
 
 
 
 
+using NSPACE::IntOption;
+using NSPACE::BoolOption;
+using NSPACE::IntRange;
+using NSPACE::StringOption;
+using NSPACE::parseOptions;
 using std::chrono::system_clock;
 using std::chrono::duration_cast;
 using std::chrono::milliseconds;
 using std::cout;
 using std::endl;
 using std::exception;
+using std::string;
+
+/** Set by SIGTERM and SIGINT when checkpointing, so that synthesis writes a last checkpoint and stops */
+static std::atomic<bool> interrupted(false);
+
+/** The signal that interrupted synthesis, for the exit status */
+static volatile std::sig_atomic_t interruptSignal = 0;
+
+/** A second signal is not caught, so that a stuck run can still be killed */
+extern "C" void onInterrupt(int sig)
+{
+	interruptSignal = sig;
+	interrupted = true;
+	std::signal(sig, SIG_DFL);
+}
+
+/** First line of the token file of distributed synthesis, or no token without a file */
+static string readWorkerToken(const char* path)
+{
+	if (!path)
+		return string();
+
+	std::ifstream file(path);
+	string token;
+
+	if (!std::getline(file, token) || token.empty())
+		throw std::runtime_error(string("Could not read a token from ") + path);
+
+	return token;
+}
 
 int main(int argc, char** argv)
 {
+	BoolOption coverageWeights("BAFSYN", "coverage-weights",
+	                           "Weight MSS toward indicators likely to appear in uncovered MFS.\n", false);
+
+	IntOption coverageWindow("BAFSYN", "coverage-window",
+	                         "Number of recent MSS used to estimate the coverage weights.\n", 4,
+	                         IntRange(0, INT32_MAX));
+
+	IntOption tinySize("BAFSYN", "tiny-size",
+	                   "Components with at most this many indicators are solved by enumeration.\n", 8,
+	                   IntRange(0, tinyComponentLimit));
+
+	BoolOption structuredMSS("BAFSYN", "structured-mss",
+	                         "Compute MSS without MaxSAT when output clauses are 2-CNF or Horn.\n", true);
+
+	BoolOption pipeline("BAFSYN", "pipeline",
+	                    "Generate MFS in a separate thread, overlapping SAT and MaxSAT calls.\n", false);
+
+	IntOption pipelineDepth("BAFSYN", "pipeline-depth",
+	                        "Maximum number of MFS the MFS thread may run ahead.\n", 64,
+	                        IntRange(1, INT32_MAX));
+
+	IntOption cubeWorkers("BAFSYN", "cube-workers",
+	                      "Number of threads used on a single large component (cube-and-conquer).\n", 1,
+	                      IntRange(1, INT32_MAX));
+
+	IntOption cubeVars("BAFSYN", "cube-vars",
+	                   "Number of indicators the cubes are split over (0 = automatic).\n", 0,
+	                   IntRange(0, 20));
+
+	IntOption cubeMinSize("BAFSYN", "cube-min-size",
+	                      "Minimum number of indicators in a component for it to be split into cubes.\n", 64,
+	                      IntRange(0, INT32_MAX));
+
+	BoolOption approximate("BAFSYN", "approximate",
+	                       "Use a single SAT call instead of MaxSAT per entry (faster, list may be longer).\n", false);
+
+	IntOption simRounds("BAFSYN", "sim-rounds",
+	                    "Rounds of 64 simulated inputs covered before the SAT-driven loop.\n", 0,
+	                    IntRange(0, INT32_MAX));
+
+	BoolOption adaptive("BAFSYN", "adaptive",
+	                    "Switch to direct MSS enumeration on components where MFS calls dominate.\n", false);
+
+	IntOption coneSize("BAFSYN", "cone-size",
+	                   "Components depending on at most this many inputs are solved by input enumeration (0 = off).\n", 0,
+	                   IntRange(0, coneEnumerationLimit));
+
+	BoolOption reuseIsomorphic("BAFSYN", "reuse-isomorphic",
+	                           "Reuse the list of a solved component for every component isomorphic to it.\n", false);
+
+	IntOption isomorphismLimit("BAFSYN", "isomorphism-limit",
+	                           "Components with more indicators are not checked for isomorphism.\n", 2000,
+	                           IntRange(0, INT32_MAX));
+
+	StringOption cacheDir("BAFSYN", "cache-dir",
+	                      "Read and store the lists of components in this directory, shared between runs.\n");
+
+	StringOption previousSpec("BAFSYN", "previous-spec",
+	                          "Earlier version of the specification, for incremental synthesis with -previous-model.\n");
+
+	StringOption previousModelPath("BAFSYN", "previous-model",
+	                               "Model of -previous-spec (see -save-model), whose lists are reused where still valid.\n");
+
+	StringOption checkpointPath("BAFSYN", "checkpoint",
+	                            "Write the lists found so far to this file periodically and when interrupted.\n");
+
+	IntOption checkpointInterval("BAFSYN", "checkpoint-interval",
+	                             "Minimum time between two checkpoints in ms.\n", 60000,
+	                             IntRange(0, INT32_MAX));
+
+	BoolOption resume("BAFSYN", "resume",
+	                  "Continue from the -checkpoint file, if it exists.\n", false);
+
+	BoolOption compile("BAFSYN", "compile",
+	                   "Compile the model to truth tables for narrow components and verify it.\n", false);
+
+	IntOption compileSupport("BAFSYN", "compile-support",
+	                         "Components reading at most this many inputs are compiled to tables.\n", 20,
+	                         IntRange(0, 24));
+
+	BoolOption zdd("BAFSYN", "zdd",
+	               "Represent the MSS family of every component as a ZDD for cover lookup.\n", false);
+
+	BoolOption minimize("BAFSYN", "minimize",
+	                    "Remove redundant MSS from the decision lists after synthesis.\n", false);
+
+	IntOption minimizeMFSLimit("BAFSYN", "minimize-mfs-limit",
+	                           "Maximum number of MFS enumerated for a minimum cover.\n", 500,
+	                           IntRange(0, INT32_MAX));
+
+	IntOption minimizeExactSize("BAFSYN", "minimize-exact-size",
+	                            "Irredundant lists with at most this many MSS get a minimum cover (MaxSAT).\n", 32,
+	                            IntRange(0, INT32_MAX));
+
+	IntOption profileSamples("BAFSYN", "profile",
+	                         "Reorder the decision lists by hit count on this many random inputs (0 = off).\n", 0,
+	                         IntRange(0, INT32_MAX));
+
+	StringOption profileTrace("BAFSYN", "profile-trace",
+	                          "Reorder the decision lists by hit count on the inputs of this file (one per line, DIMACS literals).\n");
+
+	IntOption maxsatVerbosity("Open-WBO", "verbosity",
+	                          "Verbosity level (0=minimal, 1=more).\n", 0,
+	                          IntRange(0, 1));
+
+	IntOption weightStrategy("WBO", "weight-strategy",
+	                         "Weight strategy (0=none, 1=weight-based, 2=diversity-based).\n", 2,
+	                         IntRange(0, 2));
+
+	BoolOption symmetry("WBO", "symmetry", "Symmetry breaking.\n", true);
+
+	IntOption symmetryLimit("WBO", "symmetry-limit",
+	                        "Limit on the number of symmetry breaking clauses.\n", 500000,
+	                        IntRange(0, INT32_MAX));
+
+	StringOption emitC("BAFSYN", "emit-c",
+	                   "Write a C implementation of the synthesized function to this file.\n");
+
+	StringOption emitAIG("BAFSYN", "emit-aig",
+	                     "Write the synthesized function as a binary AIGER circuit to this file.\n");
+
+	StringOption saveModelPath("BAFSYN", "save-model",
+	                           "Write the model to this binary file (memory-mappable), then map it back and verify it.\n");
+
+	StringOption batchPath("BAFSYN", "batch",
+	                       "Synthesize every specification listed in this file (one path per line, - for standard input).\n");
+
+	StringOption socketPath("BAFSYN", "socket",
+	                        "Serve synthesis jobs on a Unix-domain socket at this path.\n");
+
+	IntOption batchJobs("BAFSYN", "jobs",
+	                    "Number of batch jobs run at the same time (0 = one per core).\n", 0,
+	                    IntRange(0, INT32_MAX));
+
+	IntOption jobTimeout("BAFSYN", "job-timeout",
+	                     "Time limit per batch job in ms (0 = none).\n", 0,
+	                     IntRange(0, INT32_MAX));
+
+	IntOption jobMemory("BAFSYN", "job-memory",
+	                    "Resident memory limit per running batch job in MB (0 = none).\n", 0,
+	                    IntRange(0, INT32_MAX));
+
+	StringOption batchModels("BAFSYN", "batch-models",
+	                         "Save the model of every batch job to this directory (see -save-model).\n");
+
+	IntOption localWorkers("BAFSYN", "local-workers",
+	                       "Synthesize the components in this many worker processes on this host.\n", 0,
+	                       IntRange(0, INT32_MAX));
+
+	IntOption remoteWorkers("BAFSYN", "remote-workers",
+	                        "Wait for this many workers (see -worker) on the -listen port and synthesize the components on them.\n", 0,
+	                        IntRange(0, INT32_MAX));
+
+	IntOption listenPort("BAFSYN", "listen",
+	                     "TCP port on which remote workers connect.\n", 7171,
+	                     IntRange(1, 65535));
+
+	StringOption listenAddress("BAFSYN", "listen-address",
+	                           "Address on which remote workers connect (0.0.0.0 for all interfaces).\n", "127.0.0.1");
+
+	StringOption workerAddress("BAFSYN", "worker",
+	                           "Run as a worker of the coordinator at HOST:PORT.\n");
+
+	StringOption workerTokenFile("BAFSYN", "worker-token",
+	                             "File whose first line is a secret that remote workers and their coordinator must share.\n");
+
+	parseOptions(argc, argv, true);
+
+	SynthesisOptions options;
+	options.coverageWeights = coverageWeights;
+	options.coverageWindow = coverageWindow;
+	options.tinyComponentSize = tinySize;
+	options.structuredMSS = structuredMSS;
+	options.pipeline = pipeline;
+	options.pipelineDepth = pipelineDepth;
+	options.cubeWorkers = cubeWorkers;
+	options.cubeVars = cubeVars;
+	options.cubeMinIndicators = cubeMinSize;
+	options.approximate = approximate;
+	options.simulationRounds = simRounds;
+	options.adaptive = adaptive;
+	options.coneSize = coneSize;
+	options.reuseIsomorphic = reuseIsomorphic;
+	options.isomorphismLimit = isomorphismLimit;
+	options.minimizeMFSLimit = minimizeMFSLimit;
+	options.minimizeExactSize = minimizeExactSize;
+	options.maxsat.verbosity = maxsatVerbosity;
+	options.maxsat.weightStrategy = weightStrategy;
+	options.maxsat.symmetry = symmetry;
+	options.maxsat.symmetryLimit = symmetryLimit;
+
+	/* Shared by all the jobs of a batch */
+	std::unique_ptr<ComponentCache> cache;
+
+	if (cacheDir)
+	{
+		try
+		{
+			cache.reset(new ComponentCache(string(cacheDir)));
+		}
+		catch (const exception& e)
+		{
+			cout << e.what() << endl;
+			return 1;
+		}
+
+		options.cache = cache.get();
+	}
+
+	if (batchPath || socketPath)
+	{
+		BatchOptions batch;
+		batch.threads = batchJobs;
+		batch.timeout = jobTimeout;
+		batch.memoryLimit = jobMemory;
+		batch.minimize = minimize;
+
+		if (batchModels)
+			batch.modelDir = string(batchModels);
+
+		try
+		{
+			BatchRunner runner(options, batch);
+
+			if (socketPath)
+				serveBatch(runner, string(socketPath));
+			else if (string(batchPath) == "-")
+				runBatch(runner, std::cin, cout);
+			else
+			{
+				std::ifstream jobs(batchPath);
+
+				if (!jobs)
+					throw std::invalid_argument("Could not open " + string(batchPath));
+
+				runBatch(runner, jobs, cout);
+			}
+		}
+		catch (const exception& e)
+		{
+			cout << e.what() << endl;
+			return 1;
+		}
+
+		return 0;
+	}
+
+	if (workerAddress)
+	{
+		try
+		{
+			runWorker(string(workerAddress), readWorkerToken(workerTokenFile), options);
+		}
+		catch (const exception& e)
+		{
+			cout << e.what() << endl;
+			return 1;
+		}
+
+		return 0;
+	}
+
 	if (argc < 2)
 	{
-	  cout << "Expected format: " << argv[0] << " <input-file>" << endl;
+	  cout << "Expected format: " << argv[0] << " [options] <input-file>" << endl;
 	}
 	else
 	{
@@ -31,6 +347,22 @@ int main(int argc, char** argv)
 #if MYDEBUG
 			cout <<"*** Debug mode: " <<MYDEBUG <<" *****"<<endl;  
 #endif
+			/* Workers synthesize whole components, so they have no state to checkpoint or seed */
+			if ((localWorkers > 0 || remoteWorkers > 0) && (checkpointPath || resume || previousSpec || previousModelPath))
+				throw std::invalid_argument("-checkpoint, -resume and -previous-* are not supported with workers");
+
+			/* Local workers are forked first, while this process has a single thread */
+			WorkerPool workers;
+			workers.startLocal(localWorkers, options);
+
+			if (remoteWorkers > 0)
+			{
+				string token = readWorkerToken(workerTokenFile);
+
+				cout << "Waiting for " << remoteWorkers << " workers on " << listenAddress << ":" << listenPort << endl;
+				workers.acceptRemote(string(listenAddress), listenPort, remoteWorkers, token);
+			}
+
 			/* Path to the input file */
 			string inputPath(argv[1]);
 
@@ -55,13 +387,51 @@ int main(int argc, char** argv)
 			cout << "=== F2 ===" << endl;
 			print(cnfChain.second, "z", "y");
 #endif
+			/* Interrupted runs continue from the components completed before */
+			std::unique_ptr<Checkpoint> checkpoint;
+
+			if (resume && !checkpointPath)
+				throw std::invalid_argument("-resume needs -checkpoint");
+
+			if (checkpointPath)
+			{
+				checkpoint.reset(new Checkpoint(string(checkpointPath), f, checkpointInterval));
+
+				if (resume && checkpoint->restore())
+					cout << "Resuming from " << checkpointPath << ": " << checkpoint->restoredCount()
+					     << " components complete" << endl;
+
+				options.checkpoint = checkpoint.get();
+				options.cancel = &interrupted;
+
+				std::signal(SIGTERM, onInterrupt);
+				std::signal(SIGINT, onInterrupt);
+			}
+
+			/* Lists of the earlier version, reused by the components that an edit left valid */
+			std::unique_ptr<PreviousRun> previous;
+
+			if (previousSpec || previousModelPath)
+			{
+				if (!previousSpec || !previousModelPath)
+					throw std::invalid_argument("-previous-spec and -previous-model must be given together");
+
+				CNFSpec before = loadDIMACS(string(previousSpec));
+				CNFChain beforeChain = cnfDecomp(before);
+				Model previousModel = MappedModel(string(previousModelPath)).toModel(beforeChain.first);
+
+				previous.reset(new PreviousRun(std::move(previousModel), beforeChain, cnfChain));
+				options.previous = previous.get();
+			}
+
 			auto start = system_clock::now(); /*< start timing */
 
 			//********************************   This is the main method of the algorithm ********************************
 			/* Call the synthesis algorithm */
-			Model model =
-				//BAFAlgorithm(cnfChain.first, cnfChain.second); //        This is the non Decomposable version
-				BAFConnectedComponents(cnfChain.first, cnfChain.second);  //This is the decomposable version
+			Model model = (workers.size() > 0) ?
+				workers.synthesize(cnfChain.first, cnfChain.second, options) : //   Components solved by the workers
+				//BAFAlgorithm(cnfChain.first, cnfChain.second, options); //        This is the non Decomposable version
+				BAFConnectedComponents(cnfChain.first, cnfChain.second, options);  //This is the decomposable version
         
 			//************************************************************************************************************  
 
@@ -98,8 +468,80 @@ int main(int argc, char** argv)
 
 			cout << "=== Stats ===" << endl;
 
+			if (minimize)
+			{
+				size_t before = model.mssCount();
+				auto minimizeStart = system_clock::now();
+
+				minimizeModel(model, cnfChain.first, cnfChain.second, options);
+
+				auto minimizeTime = duration_cast<milliseconds>(system_clock::now() - minimizeStart);
+
+				cout << "Decision-list length before minimization: " << before << endl;
+				cout << "Minimization time: " << minimizeTime.count() << "ms" << endl;
+			}
+
 			cout << "Decision-list length: " << model.mssCount() << endl;
+
+			if (workers.size() > 0)
+				cout << "Workers: " << workers.size() << endl;
+
+			if (previous)
+				cout << "Unchanged components: " << previous->unchangedCount()
+				     << " (seed entries offered: " << previous->seedCount() << ")" << endl;
+
+			if (checkpoint)
+			{
+				cout << "Checkpoints written: " << checkpoint->writeCount() << endl;
+
+				if (checkpoint->failedWriteCount() > 0)
+					cout << "Checkpoint writes failed: " << checkpoint->failedWriteCount() << endl;
+			}
+
+			if (cache)
+			{
+				cout << "Cached components: " << cache->hits() << " of " << cache->hits() + cache->misses() << endl;
+
+				if (cache->failedStores() > 0)
+					cout << "Lists not stored in the cache: " << cache->failedStores() << endl;
+			}
+
+			if (profileSamples > 0 || profileTrace)
+			{
+				Vector<Set<BVar>> profileInputs = profileTrace ?
+					readTrace(string(profileTrace)) :
+					randomInputs(f.inputVars(), profileSamples);
+
+				HitCounts hits = countHits(model, cnfChain.first, profileInputs);
+				double before = meanScanLength(hits);
+
+				orderByHits(model, hits);
+
+				double after = meanScanLength(countHits(model, cnfChain.first, profileInputs));
+
+				cout << "Mean scan length: " << before << " -> " << after
+				     << " (" << profileInputs.size() << " profiled inputs)" << endl;
+			}
 			cout << "Synthesis time: " << time.count() << "ms" << endl;
+
+			if (zdd)
+			{
+				size_t listSize = 0;
+
+				for (size_t i = 0; i < model.componentCount(); i++)
+					for (const Set<BVar>& mss : model.mssForComponent(i))
+						listSize += mss.size();
+
+				model.buildZDD();
+
+				cout << "ZDD nodes: " << model.zddNodeCount() << " (list elements: " << listSize << ")" << endl;
+			}
+
+			if (options.approximate) /*< how far the list is from one made of exact MSS */
+			{
+				cout << "Non-maximal entries: " << nonMaximalCount(model, cnfChain.second) << endl;
+				cout << "Subsumed entries: " << model.subsumedCount() << endl;
+			}
       
       
 			/* DF: 4/4/2018 Adding a verifier object that is generated by the MSS list and perform various verification on the list.*/
@@ -115,6 +557,62 @@ int main(int argc, char** argv)
 			else
 				ok &= MyVerifier.RandomVerifyInputCover(); //< otherwise, select a random sample 
       
+			if (compile)
+			{
+				auto compileStart = system_clock::now();
+
+				CompiledModel compiled(model, cnfChain.first, f.outputVars(), compileSupport);
+
+				auto compileTime = duration_cast<milliseconds>(system_clock::now() - compileStart);
+
+				cout << "Tabulated components: " << compiled.tabulatedCount() << " of " << compiled.componentCount() << endl;
+				cout << "Table cells: " << compiled.tableSize() << endl;
+				cout << "Compilation time: " << compileTime.count() << "ms" << endl;
+
+				ok &= MyVerifier.VerifyCompiledModel(compiled);
+			}
+
+			if (saveModelPath)
+			{
+				string path(saveModelPath);
+
+				saveModel(path, model, cnfChain.first, f);
+
+				auto mapStart = system_clock::now();
+				MappedModel mapped(path);
+				auto mapTime = duration_cast<std::chrono::microseconds>(system_clock::now() - mapStart);
+
+				cout << "Model written to " << path << ": " << mapped.fileSize() << " bytes, mapped in "
+				     << mapTime.count() << "us" << endl;
+
+				ok &= MyVerifier.VerifyMappedModel(mapped);
+			}
+
+			if (emitC)
+			{
+				std::ofstream file(emitC);
+
+				if (!file)
+					throw std::invalid_argument("Could not open " + string(emitC));
+
+				generateC(file, model, cnfChain.first, f);
+
+				cout << "C code written to " << emitC << endl;
+			}
+
+			if (emitAIG)
+			{
+				std::ofstream file(emitAIG, std::ios::binary);
+
+				if (!file)
+					throw std::invalid_argument("Could not open " + string(emitAIG));
+
+				AIG circuit = modelCircuit(model, cnfChain.first, f);
+				circuit.writeAIGER(file);
+
+				cout << "AIG written to " << emitAIG << ": " << circuit.andCount() << " AND gates" << endl;
+			}
+
 			if (ok)
 				cout << "The model passed the verification" << endl;
 			else
@@ -173,6 +671,11 @@ int main(int argc, char** argv)
 		}
     
     
+		catch (const SynthesisCancelled& e)
+		{
+			cout << e.what() << endl;
+			return 128 + interruptSignal;
+		}
 		catch (const exception& e)
 		{
 			cout << e.what() << endl;
@@ -1,8 +1,5 @@
-#include <algorithm>
-
 #include "Model.hpp"
 
-using std::any_of;
 using std::move;
 
 size_t Model::addComponent(Set<BVar> component)
@@ -11,15 +8,38 @@ size_t Model::addComponent(Set<BVar> component)
 
 	_componentList.push_back(move(component));
 	_componentMSS.emplace_back(); /*< initialize empty vector of MSS */
+	_componentIndex.emplace_back();
 
 	return id;
 }
 
 void Model::addMSS(size_t componentId, Set<BVar> mss)
 {
+	/* Only the indicators are indexed, covers are looked up for sets of indicators */
+	_componentIndex[componentId].insert(setIntersection(mss, _componentList[componentId]),
+	                                    _componentMSS[componentId].size());
+
+	if (!_componentZDD.empty())
+	{
+		_componentZDD[componentId].insert(mss);
+		_componentZDD[componentId].compact();
+	}
+
 	_componentMSS[componentId].push_back(move(mss));
 }
 
+void Model::replaceMSSList(size_t componentId, Vector<Set<BVar>> mssList)
+{
+	_componentMSS[componentId].clear();
+	_componentIndex[componentId] = SetTrie();
+
+	if (!_componentZDD.empty())
+		_componentZDD[componentId] = ZDD();
+
+	for (Set<BVar>& mss : mssList)
+		addMSS(componentId, move(mss));
+}
+
 const Vector<Set<BVar>>& Model::allComponents() const
 {
 	return _componentList;
@@ -47,11 +67,71 @@ size_t Model::mssCount() const
 	return count;
 }
 
-bool Model::alreadyCovered(size_t componentId, const Set<BVar>& s)
+size_t Model::subsumedCount() const
+{
+	size_t count = 0;
+
+	for (const Vector<Set<BVar>>& mssList : _componentMSS)
+	{
+		for (size_t i = 0; i < mssList.size(); i++)
+		{
+			for (size_t j = 0; j < mssList.size(); j++)
+			{
+				if (i != j && mssList[i].size() <= mssList[j].size() && isSubset(mssList[i], mssList[j])
+				    && (mssList[i] != mssList[j] || i > j))
+				{
+					count++;
+					break;
+				}
+			}
+		}
+	}
+
+	return count;
+}
+
+bool Model::alreadyCovered(size_t componentId, const Set<BVar>& s) const
 {
-	auto isSuperset = [&s] (const Set<BVar>& mss) { return isSubset(s, mss); };
-	
-	return any_of(_componentMSS[componentId].begin(),
-	              _componentMSS[componentId].end(),
-	              isSuperset);
+	return _componentIndex[componentId].findSuperset(s) != SetTrie::none;
+}
+
+Optional<size_t> Model::findCover(size_t componentId, const Set<BVar>& s) const
+{
+	size_t position = _componentIndex[componentId].findSuperset(s);
+
+	if (position == SetTrie::none)
+		return nullopt;
+
+	return position;
+}
+
+void Model::buildZDD()
+{
+	_componentZDD.clear();
+
+	for (const Vector<Set<BVar>>& mssList : _componentMSS)
+		_componentZDD.emplace_back(mssList);
+}
+
+size_t Model::zddNodeCount() const
+{
+	size_t count = 0;
+
+	for (const ZDD& zdd : _componentZDD)
+		count += zdd.nodeCount();
+
+	return count;
+}
+
+Optional<Set<BVar>> Model::coveringMSS(size_t componentId, const Set<BVar>& s) const
+{
+	if (!_componentZDD.empty())
+		return _componentZDD[componentId].findSuperset(s);
+
+	Optional<size_t> position = findCover(componentId, s);
+
+	if (!position)
+		return nullopt;
+
+	return _componentMSS[componentId][*position];
 }
@@ -3,6 +3,9 @@
 #include "Vector.hpp"
 #include "Set.hpp"
 #include "CNFFormula.hpp"
+#include "SetTrie.hpp"
+#include "ZDD.hpp"
+#include "Optional.hpp"
 
 /**
  * Class representing the function being synthesized.
@@ -18,6 +21,12 @@ class Model
 	/** List of MSS for each component */
 	Vector<Vector<Set<BVar>>> _componentMSS;
 
+	/** Index over the indicators of the MSS of each component, by position in the list */
+	Vector<SetTrie> _componentIndex;
+
+	/** ZDD of the MSS family of each component, empty until buildZDD is called */
+	Vector<ZDD> _componentZDD;
+
 public:
 
 	size_t componentCount() const;
@@ -35,6 +44,37 @@ public:
 	/** Adds MSS to MSS list of the component with the given identifier */
 	void addMSS(size_t componentId, Set<BVar> mss);
 
-	/* Returns true if the given set is a subset of any MSS of the given component */
-	bool alreadyCovered(size_t componentId, const Set<BVar>& s);
+	/**
+	 * Returns the number of MSS that are subsets of another MSS of the same component.
+	 * Such entries are never needed, so this is zero when all entries are maximal.
+	 */
+	size_t subsumedCount() const;
+
+	/** Replaces the MSS list of the component with the given identifier */
+	void replaceMSSList(size_t componentId, Vector<Set<BVar>> mssList);
+
+	/* Returns true if the given set of indicators is a subset of any MSS of the given component */
+	bool alreadyCovered(size_t componentId, const Set<BVar>& s) const;
+
+	/**
+	 * Returns the position of the first MSS of the given component containing the
+	 * given set of indicators of the component, or nothing if no MSS contains it.
+	 */
+	Optional<size_t> findCover(size_t componentId, const Set<BVar>& s) const;
+
+	/**
+	 * Represents the MSS family of every component as a ZDD, which is kept up to date
+	 * by addMSS and answers coveringMSS from then on.
+	 */
+	void buildZDD();
+
+	/** Returns the number of ZDD nodes over all components (0 before buildZDD) */
+	size_t zddNodeCount() const;
+
+	/**
+	 * Returns an MSS of the given component containing the given set of indicators,
+	 * or nothing if no MSS contains it. Any such MSS determines a correct output; it is
+	 * the first one in the list, unless the ZDD was built.
+	 */
+	Optional<Set<BVar>> coveringMSS(size_t componentId, const Set<BVar>& s) const;
 };
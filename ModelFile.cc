@@ -0,0 +1,478 @@
+#include "ModelFile.hpp"
+#include "Map.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using std::string;
+using std::runtime_error;
+
+static_assert(sizeof(ModelFileHeader) == 104, "Model file header must have no padding");
+static_assert(sizeof(ModelFileComponent) == 32, "Model file component must have no padding");
+
+namespace
+{
+	const char modelFileMagic[8] = "BAFSYNM";
+
+	/** Offset of a section of the given number of bytes starting at the given offset, aligned to 8 bytes */
+	uint64_t nextOffset(uint64_t offset, uint64_t bytes)
+	{
+		return (offset + bytes + 7) & ~uint64_t(7);
+	}
+
+	template <class T>
+	void writeSection(std::ofstream& file, uint64_t offset, const Vector<T>& elements)
+	{
+		file.seekp(offset);
+		file.write(reinterpret_cast<const char*>(elements.data()), elements.size() * sizeof(T));
+	}
+}
+
+void saveModel(const string& path, const Model& model, const TrivialSpec& f1, const CNFSpec& spec)
+{
+	Vector<uint32_t> inputVars(spec.inputVars().begin(), spec.inputVars().end());
+	Vector<uint32_t> outputVars(spec.outputVars().begin(), spec.outputVars().end());
+
+	Map<BVar, uint32_t> inputPosition;
+	Map<BVar, uint32_t> outputPosition;
+
+	for (size_t k = 0; k < inputVars.size(); k++)
+		inputPosition[inputVars[k]] = k;
+
+	for (size_t k = 0; k < outputVars.size(); k++)
+		outputPosition[outputVars[k]] = k;
+
+	Vector<uint32_t> definitionStart(1, 0);
+	Vector<int32_t> definitionLits;
+	Map<BVar, uint32_t> definitionOf; /*< definitionOf[z_i] == i */
+
+	f1.forEach([&] (BVar z, const CNFClause& negDefinition)
+	{
+		definitionOf[z] = definitionStart.size() - 1;
+
+		for (BLit lit : negDefinition)
+		{
+			int32_t k = inputPosition.at(abs(lit)) + 1;
+			definitionLits.push_back((lit > 0) ? k : -k);
+		}
+
+		definitionStart.push_back(definitionLits.size());
+	});
+
+	Vector<ModelFileComponent> components;
+	Vector<uint32_t> componentVars;
+	Vector<uint64_t> masks;
+
+	for (size_t c = 0; c < model.componentCount(); c++)
+	{
+		const Vector<Set<BVar>>& entries = model.mssForComponent(c);
+
+		Map<BVar, size_t> bit; /*< bit of every indicator and output of the component in the masks */
+		Set<BVar> outputs;
+
+		ModelFileComponent component;
+		component.varsOffset = componentVars.size();
+		component.maskOffset = masks.size();
+
+		for (BVar z : model.allComponents()[c])
+		{
+			size_t b = bit.size();
+			bit[z] = b;
+			componentVars.push_back(definitionOf.at(z));
+		}
+
+		for (const Set<BVar>& mss : entries)
+			for (BVar var : mss)
+				if (outputPosition.find(var) != outputPosition.end())
+					outputs.insert(var);
+
+		for (BVar y : outputs)
+		{
+			size_t b = bit.size();
+			bit[y] = b;
+			componentVars.push_back(outputPosition[y]);
+		}
+
+		component.indicatorCount = model.allComponents()[c].size();
+		component.outputCount = outputs.size();
+		component.entryCount = entries.size();
+		component.maskWords = std::max<size_t>((bit.size() + 63) / 64, 1);
+
+		for (const Set<BVar>& mss : entries)
+		{
+			Vector<uint64_t> mask(component.maskWords, 0);
+
+			for (BVar var : mss)
+			{
+				auto it = bit.find(var);
+
+				if (it != bit.end())
+					mask[it->second / 64] |= uint64_t(1) << (it->second % 64);
+			}
+
+			masks.insert(masks.end(), mask.begin(), mask.end());
+		}
+
+		components.push_back(component);
+	}
+
+	ModelFileHeader header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, modelFileMagic, sizeof(header.magic));
+
+	header.version = modelFileVersion;
+	header.byteOrderMark = modelFileByteOrderMark;
+	header.inputCount = inputVars.size();
+	header.outputCount = outputVars.size();
+	header.definitionCount = definitionStart.size() - 1;
+	header.componentCount = components.size();
+	header.entryCount = model.mssCount();
+
+	header.inputVarsOffset = sizeof(header);
+	header.outputVarsOffset = nextOffset(header.inputVarsOffset, inputVars.size() * sizeof(uint32_t));
+	header.definitionStartOffset = nextOffset(header.outputVarsOffset, outputVars.size() * sizeof(uint32_t));
+	header.definitionLitsOffset = nextOffset(header.definitionStartOffset, definitionStart.size() * sizeof(uint32_t));
+	header.componentsOffset = nextOffset(header.definitionLitsOffset, definitionLits.size() * sizeof(int32_t));
+	header.componentVarsOffset = nextOffset(header.componentsOffset, components.size() * sizeof(ModelFileComponent));
+	header.masksOffset = nextOffset(header.componentVarsOffset, componentVars.size() * sizeof(uint32_t));
+	header.fileSize = header.masksOffset + masks.size() * sizeof(uint64_t);
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+	if (!file)
+		throw runtime_error("Could not open " + path);
+
+	/* Gaps between sections are filled with zeros by writing the last byte first */
+	file.seekp(header.fileSize - 1);
+	file.put(0);
+	file.seekp(0);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	writeSection(file, header.inputVarsOffset, inputVars);
+	writeSection(file, header.outputVarsOffset, outputVars);
+	writeSection(file, header.definitionStartOffset, definitionStart);
+	writeSection(file, header.definitionLitsOffset, definitionLits);
+	writeSection(file, header.componentsOffset, components);
+	writeSection(file, header.componentVarsOffset, componentVars);
+	writeSection(file, header.masksOffset, masks);
+
+	if (!file.flush())
+		throw runtime_error("Could not write " + path);
+}
+
+MappedModel::MappedModel(const string& path)
+{
+	int fd = open(path.c_str(), O_RDONLY);
+
+	if (fd < 0)
+		throw runtime_error("Could not open " + path);
+
+	struct stat status;
+
+	if (fstat(fd, &status) != 0 || size_t(status.st_size) < sizeof(ModelFileHeader))
+	{
+		close(fd);
+		throw runtime_error(path + " is not a model file");
+	}
+
+	_size = status.st_size;
+	void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); /*< the mapping stays valid */
+
+	if (data == MAP_FAILED)
+		throw runtime_error("Could not map " + path);
+
+	_data = static_cast<const uint8_t*>(data);
+
+	const ModelFileHeader& h = header();
+
+	auto fail = [&] (const string& reason)
+	{
+		munmap(const_cast<uint8_t*>(_data), _size);
+		throw runtime_error(path + ": " + reason);
+	};
+
+	if (std::memcmp(h.magic, modelFileMagic, sizeof(h.magic)) != 0)
+		fail("not a model file");
+	if (h.byteOrderMark != modelFileByteOrderMark)
+		fail("written with a different byte order");
+	if (h.version != modelFileVersion)
+		fail("unsupported version " + std::to_string(h.version));
+	if (h.fileSize != _size)
+		fail("truncated");
+
+	/* Every section must lie in the file, at an aligned offset */
+	auto inFile = [this] (uint64_t offset, uint64_t count, uint64_t elementSize)
+	{
+		return offset % 8 == 0 && offset <= _size && count <= (_size - offset) / elementSize;
+	};
+
+	const uint32_t* definitionStart = section<uint32_t>(h.definitionStartOffset);
+
+	if (!inFile(h.inputVarsOffset, h.inputCount, sizeof(uint32_t))
+	    || !inFile(h.outputVarsOffset, h.outputCount, sizeof(uint32_t))
+	    || !inFile(h.definitionStartOffset, uint64_t(h.definitionCount) + 1, sizeof(uint32_t))
+	    || !inFile(h.componentsOffset, h.componentCount, sizeof(ModelFileComponent))
+	    || h.componentVarsOffset % 8 != 0 || h.masksOffset % 8 != 0
+	    || h.componentVarsOffset > h.masksOffset || h.masksOffset > _size)
+		fail("corrupt section table");
+
+	uint64_t litCount = definitionStart[h.definitionCount];
+
+	if (!inFile(h.definitionLitsOffset, litCount, sizeof(int32_t)))
+		fail("corrupt definitions");
+
+	const int32_t* definitionLits = section<int32_t>(h.definitionLitsOffset);
+
+	for (size_t i = 0; i < h.definitionCount; i++)
+		if (definitionStart[i] > definitionStart[i + 1])
+			fail("corrupt definitions");
+
+	for (uint64_t l = 0; l < litCount; l++)
+		if (definitionLits[l] == 0 || uint32_t(std::abs(definitionLits[l])) > h.inputCount)
+			fail("corrupt definitions");
+
+	uint64_t varCount = (h.masksOffset - h.componentVarsOffset) / sizeof(uint32_t);
+	uint64_t maskCount = (_size - h.masksOffset) / sizeof(uint64_t);
+	const ModelFileComponent* components = section<ModelFileComponent>(h.componentsOffset);
+	const uint32_t* componentVars = section<uint32_t>(h.componentVarsOffset);
+
+	for (size_t c = 0; c < h.componentCount; c++)
+	{
+		const ModelFileComponent& component = components[c];
+		uint64_t vars = uint64_t(component.indicatorCount) + component.outputCount;
+
+		if (component.varsOffset > varCount || vars > varCount - component.varsOffset
+		    || component.maskWords * uint64_t(64) < vars || component.maskWords == 0
+		    || component.maskOffset > maskCount
+		    || uint64_t(component.entryCount) * component.maskWords > maskCount - component.maskOffset)
+			fail("corrupt component " + std::to_string(c));
+
+		for (uint64_t v = 0; v < vars; v++)
+		{
+			uint32_t limit = (v < component.indicatorCount) ? h.definitionCount : h.outputCount;
+
+			if (componentVars[component.varsOffset + v] >= limit)
+				fail("corrupt component " + std::to_string(c));
+		}
+
+		_maxMaskWords = std::max<size_t>(_maxMaskWords, component.maskWords);
+	}
+}
+
+MappedModel::~MappedModel()
+{
+	munmap(const_cast<uint8_t*>(_data), _size);
+}
+
+const ModelFileHeader& MappedModel::header() const
+{
+	return *reinterpret_cast<const ModelFileHeader*>(_data);
+}
+
+size_t MappedModel::inputCount() const
+{
+	return header().inputCount;
+}
+
+size_t MappedModel::outputCount() const
+{
+	return header().outputCount;
+}
+
+size_t MappedModel::componentCount() const
+{
+	return header().componentCount;
+}
+
+size_t MappedModel::entryCount() const
+{
+	return header().entryCount;
+}
+
+size_t MappedModel::fileSize() const
+{
+	return _size;
+}
+
+const uint32_t* MappedModel::inputVars() const
+{
+	return section<uint32_t>(header().inputVarsOffset);
+}
+
+const uint32_t* MappedModel::outputVars() const
+{
+	return section<uint32_t>(header().outputVarsOffset);
+}
+
+void MappedModel::eval(const uint8_t* x, uint8_t* y) const
+{
+	const ModelFileHeader& h = header();
+	const uint32_t* definitionStart = section<uint32_t>(h.definitionStartOffset);
+	const int32_t* definitionLits = section<int32_t>(h.definitionLitsOffset);
+	const ModelFileComponent* components = section<ModelFileComponent>(h.componentsOffset);
+	const uint32_t* componentVars = section<uint32_t>(h.componentVarsOffset);
+	const uint64_t* masks = section<uint64_t>(h.masksOffset);
+
+	std::fill(y, y + h.outputCount, 0);
+
+	/* Indicator bits of the component, on the stack unless the model has very wide components */
+	uint64_t local[8];
+	Vector<uint64_t> wide(_maxMaskWords > 8 ? _maxMaskWords : 0);
+	uint64_t* z = (_maxMaskWords > 8) ? wide.data() : local;
+
+	for (size_t c = 0; c < h.componentCount; c++)
+	{
+		const ModelFileComponent& component = components[c];
+		const uint32_t* vars = componentVars + component.varsOffset;
+
+		std::fill(z, z + component.maskWords, 0);
+
+		/* z_i is true iff every literal of X_i is false */
+		for (size_t d = 0; d < component.indicatorCount; d++)
+		{
+			bool value = true;
+
+			for (uint32_t l = definitionStart[vars[d]]; l < definitionStart[vars[d] + 1] && value; l++)
+			{
+				int32_t lit = definitionLits[l];
+				value = (x[std::abs(lit) - 1] != 0) != (lit > 0);
+			}
+
+			z[d / 64] |= uint64_t(value) << (d % 64);
+		}
+
+		const uint64_t* mask = masks + component.maskOffset;
+		size_t j = 0;
+
+		for (; j < component.entryCount; j++, mask += component.maskWords)
+		{
+			bool covered = true;
+
+			for (size_t w = 0; w < component.maskWords && covered; w++)
+				covered = !(z[w] & ~mask[w]);
+
+			if (covered)
+				break;
+		}
+
+		if (j == component.entryCount)
+			throw runtime_error("Input not covered by the model");
+
+		for (size_t k = 0; k < component.outputCount; k++)
+		{
+			size_t b = component.indicatorCount + k;
+
+			if ((mask[b / 64] >> (b % 64)) & 1)
+				y[vars[b]] = 1;
+		}
+	}
+}
+
+Set<BVar> MappedModel::eval(const Set<BVar>& inputAssignment) const
+{
+	const uint32_t* inputs = inputVars();
+	const uint32_t* outputs = outputVars();
+
+	Vector<uint8_t> x(inputCount(), 0);
+	Vector<uint8_t> y(outputCount(), 0);
+
+	for (BVar var : inputAssignment)
+	{
+		const uint32_t* it = std::lower_bound(inputs, inputs + inputCount(), uint32_t(var));
+
+		if (it != inputs + inputCount() && *it == uint32_t(var))
+			x[it - inputs] = 1;
+	}
+
+	eval(x.data(), y.data());
+
+	Set<BVar> result;
+
+	for (size_t k = 0; k < y.size(); k++)
+		if (y[k])
+			result.insert(outputs[k]);
+
+	return result;
+}
+
+Model MappedModel::toModel(const TrivialSpec& f1) const
+{
+	const ModelFileHeader& h = header();
+	const uint32_t* definitionStart = section<uint32_t>(h.definitionStartOffset);
+	const int32_t* definitionLits = section<int32_t>(h.definitionLitsOffset);
+	const ModelFileComponent* components = section<ModelFileComponent>(h.componentsOffset);
+	const uint32_t* componentVars = section<uint32_t>(h.componentVarsOffset);
+	const uint64_t* masks = section<uint64_t>(h.masksOffset);
+	const uint32_t* inputs = inputVars();
+	const uint32_t* outputs = outputVars();
+
+	Vector<BVar> indicatorOf; /*< indicatorOf[i] == z_i */
+	bool same = true;
+
+	f1.forEach([&] (BVar z, const CNFClause& negDefinition)
+	{
+		size_t i = indicatorOf.size();
+		indicatorOf.push_back(z);
+
+		Vector<BLit> lits(negDefinition.begin(), negDefinition.end());
+
+		if (i >= h.definitionCount || lits.size() != definitionStart[i + 1] - definitionStart[i])
+		{
+			same = false;
+			return;
+		}
+
+		for (size_t l = 0; l < lits.size(); l++)
+		{
+			int32_t k = definitionLits[definitionStart[i] + l];
+			same &= (lits[l] == ((k > 0) ? BLit(inputs[k - 1]) : -BLit(inputs[-k - 1])));
+		}
+	});
+
+	if (!same || indicatorOf.size() != h.definitionCount)
+		throw runtime_error("Model file does not match the definitions of the specification");
+
+	Model model;
+
+	for (size_t c = 0; c < h.componentCount; c++)
+	{
+		const ModelFileComponent& component = components[c];
+		const uint32_t* vars = componentVars + component.varsOffset;
+
+		Vector<BVar> varOfBit;
+		Set<BVar> indicators;
+
+		for (size_t b = 0; b < component.indicatorCount; b++)
+		{
+			varOfBit.push_back(indicatorOf[vars[b]]);
+			indicators.insert(indicatorOf[vars[b]]);
+		}
+
+		for (size_t b = component.indicatorCount; b < size_t(component.indicatorCount) + component.outputCount; b++)
+			varOfBit.push_back(outputs[vars[b]]);
+
+		size_t componentId = model.addComponent(indicators);
+
+		for (size_t e = 0; e < component.entryCount; e++)
+		{
+			const uint64_t* mask = masks + component.maskOffset + e * component.maskWords;
+			Set<BVar> entry;
+
+			for (size_t b = 0; b < varOfBit.size(); b++)
+				if (mask[b / 64] & (uint64_t(1) << (b % 64)))
+					entry.insert(varOfBit[b]);
+
+			model.addMSS(componentId, std::move(entry));
+		}
+	}
+
+	return model;
+}
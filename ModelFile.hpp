@@ -0,0 +1,126 @@
+#pragma once
+
+#include "CNFFormula.hpp"
+#include "CNFSpec.hpp"
+#include "TrivialSpec.hpp"
+#include "Model.hpp"
+#include "Set.hpp"
+#include "Vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Binary model file, laid out to be used in place after mmap.
+ *
+ * The file starts with a ModelFileHeader followed by sections at 8-byte aligned offsets:
+ *
+ * - inputVars: uint32_t[inputCount], DIMACS variable of every input, increasing;
+ * - outputVars: uint32_t[outputCount], DIMACS variable of every output, increasing;
+ * - definitionStart: uint32_t[definitionCount + 1], literals of X_i are definitionLits[definitionStart[i] ..
+ *   definitionStart[i + 1]);
+ * - definitionLits: int32_t[], literals over input positions, +(k + 1) or -(k + 1);
+ * - components: ModelFileComponent[componentCount];
+ * - componentVars: uint32_t[], for every component the definitions of its indicators, then the
+ *   positions of its outputs;
+ * - masks: uint64_t[], for every entry maskWords words: bit d is indicator d of the component
+ *   and bit indicatorCount + k is output k of the component.
+ *
+ * Integers are stored in the byte order of the writer, which the reader checks with byteOrderMark.
+ * Files with a different version are rejected.
+ */
+struct ModelFileHeader
+{
+	char magic[8]; /*< "BAFSYNM" */
+	uint32_t version;
+	uint32_t byteOrderMark; /*< modelFileByteOrderMark */
+	uint32_t inputCount;
+	uint32_t outputCount;
+	uint32_t definitionCount;
+	uint32_t componentCount;
+	uint32_t entryCount;
+	uint32_t reserved;
+	uint64_t fileSize;
+	uint64_t inputVarsOffset;
+	uint64_t outputVarsOffset;
+	uint64_t definitionStartOffset;
+	uint64_t definitionLitsOffset;
+	uint64_t componentsOffset;
+	uint64_t componentVarsOffset;
+	uint64_t masksOffset;
+};
+
+/** Component of a model file, offsets are in elements of componentVars and masks */
+struct ModelFileComponent
+{
+	uint32_t indicatorCount;
+	uint32_t outputCount;
+	uint32_t entryCount;
+	uint32_t maskWords;
+	uint64_t varsOffset;
+	uint64_t maskOffset;
+};
+
+const uint32_t modelFileVersion = 1;
+const uint32_t modelFileByteOrderMark = 0x01020304;
+
+/** Writes the model, with the definitions of F1, to a binary model file */
+void saveModel(const std::string& path, const Model& model, const TrivialSpec& f1, const CNFSpec& spec);
+
+/**
+ * Read-only view of a binary model file mapped in memory.
+ *
+ * Opening only validates the header, the definitions and the bounds of every component, so
+ * its cost does not depend on the number of entries; evaluation reads the mapped data directly
+ * with first-match semantics.
+ */
+class MappedModel
+{
+	const uint8_t* _data = nullptr;
+	size_t _size = 0;
+	size_t _maxMaskWords = 0;
+
+	const ModelFileHeader& header() const;
+
+	template <class T>
+	const T* section(uint64_t offset) const
+	{
+		return reinterpret_cast<const T*>(_data + offset);
+	}
+
+public:
+
+	/** Maps the file, throws std::runtime_error if it is not a valid model file */
+	explicit MappedModel(const std::string& path);
+	~MappedModel();
+
+	MappedModel(const MappedModel&) = delete;
+	MappedModel& operator=(const MappedModel&) = delete;
+
+	size_t inputCount() const;
+	size_t outputCount() const;
+	size_t componentCount() const;
+	size_t entryCount() const;
+	size_t fileSize() const;
+
+	/** DIMACS variables of the inputs and outputs, by position */
+	const uint32_t* inputVars() const;
+	const uint32_t* outputVars() const;
+
+	/**
+	 * Sets y[k] to the value of output k for the input where x[k] is the value of input k.
+	 * Throws std::runtime_error if some component has no entry covering the input.
+	 */
+	void eval(const uint8_t* x, uint8_t* y) const;
+
+	/** Returns the output variables set to true for the given assignment (set of input variables set to true) */
+	Set<BVar> eval(const Set<BVar>& inputAssignment) const;
+
+	/**
+	 * Rebuilds the model over the indicators of f1, which must have the definitions of the
+	 * file in the same order (F1 of the specification the file was written for). Throws
+	 * std::runtime_error otherwise.
+	 */
+	Model toModel(const TrivialSpec& f1) const;
+};
@@ -0,0 +1,168 @@
+#include "Profiling.hpp"
+#include "Simulator.hpp"
+#include "Map.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+using std::string;
+
+HitCounts countHits(const Model& model, const TrivialSpec& f1, const Vector<Set<BVar>>& inputs)
+{
+	Simulator simulator(f1);
+
+	/* Indicator z_i of every definition i */
+	Vector<BVar> defined;
+	f1.forEach([&defined] (BVar z, const CNFClause&) { defined.push_back(z); });
+
+	Map<BVar, size_t> position; /*< position of every input variable in simulator.inputs() */
+
+	for (size_t k = 0; k < simulator.inputs().size(); k++)
+		position[simulator.inputs()[k]] = k;
+
+	/* Definitions of every component */
+	Map<BVar, size_t> definitionOf;
+
+	for (size_t i = 0; i < defined.size(); i++)
+		definitionOf[defined[i]] = i;
+
+	Vector<Vector<size_t>> definitions(model.componentCount());
+
+	for (size_t c = 0; c < model.componentCount(); c++)
+		for (BVar z : model.allComponents()[c])
+			definitions[c].push_back(definitionOf.at(z));
+
+	HitCounts hits(model.componentCount());
+
+	for (size_t c = 0; c < model.componentCount(); c++)
+		hits[c].assign(model.mssForComponent(c).size(), 0);
+
+	for (size_t first = 0; first < inputs.size(); first += 64)
+	{
+		size_t laneCount = std::min<size_t>(64, inputs.size() - first);
+
+		Vector<uint64_t> words(simulator.inputs().size(), 0);
+
+		for (size_t lane = 0; lane < laneCount; lane++)
+		{
+			for (BVar x : inputs[first + lane])
+			{
+				auto it = position.find(x);
+
+				if (it != position.end()) /*< inputs not read by F1 do not matter */
+					words[it->second] |= uint64_t(1) << lane;
+			}
+		}
+
+		for (size_t c = 0; c < model.componentCount(); c++)
+		{
+			Vector<uint64_t> lanes = simulator.simulate(words, definitions[c]);
+
+			for (size_t lane = 0; lane < laneCount; lane++)
+			{
+				Set<BVar> active;
+
+				for (size_t d = 0; d < definitions[c].size(); d++)
+					if ((lanes[d] >> lane) & 1)
+						active.insert(defined[definitions[c][d]]);
+
+				Optional<size_t> entry = model.findCover(c, active);
+
+				if (!entry)
+					throw std::invalid_argument("Input not covered by the model");
+
+				hits[c][*entry]++;
+			}
+		}
+	}
+
+	return hits;
+}
+
+double meanScanLength(const HitCounts& hits)
+{
+	uint64_t inputs = 0;
+	uint64_t scanned = 0;
+
+	for (const Vector<uint64_t>& componentHits : hits)
+	{
+		uint64_t count = 0;
+
+		for (size_t j = 0; j < componentHits.size(); j++)
+		{
+			count += componentHits[j];
+			scanned += (j + 1) * componentHits[j];
+		}
+
+		/* Every input is counted once per component */
+		inputs = std::max(inputs, count);
+	}
+
+	return inputs ? double(scanned) / inputs : 0;
+}
+
+void orderByHits(Model& model, const HitCounts& hits)
+{
+	for (size_t c = 0; c < model.componentCount(); c++)
+	{
+		Vector<size_t> order(hits[c].size());
+		std::iota(order.begin(), order.end(), 0);
+
+		std::stable_sort(order.begin(), order.end(),
+		                 [&] (size_t a, size_t b) { return hits[c][a] > hits[c][b]; });
+
+		Vector<Set<BVar>> reordered;
+
+		for (size_t j : order)
+			reordered.push_back(model.mssForComponent(c)[j]);
+
+		model.replaceMSSList(c, std::move(reordered));
+	}
+}
+
+Vector<Set<BVar>> readTrace(const string& path)
+{
+	std::ifstream in(path);
+
+	if (!in)
+		throw std::runtime_error("Cannot open trace file " + path);
+
+	Vector<Set<BVar>> inputs;
+	string line;
+
+	while (getline(in, line))
+	{
+		if (line.empty() || line[0] == 'c')
+			continue;
+
+		std::istringstream literals(line);
+		Set<BVar> input;
+		BLit lit;
+
+		while (literals >> lit && lit != 0)
+			if (lit > 0)
+				input.insert(lit);
+
+		inputs.push_back(input);
+	}
+
+	return inputs;
+}
+
+Vector<Set<BVar>> randomInputs(const Set<BVar>& inputVars, size_t count, uint64_t seed)
+{
+	std::mt19937_64 rng(seed);
+
+	Vector<Set<BVar>> inputs(count);
+
+	for (Set<BVar>& input : inputs)
+		for (BVar x : inputVars)
+			if (rng() & 1)
+				input.insert(x);
+
+	return inputs;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CNFFormula.hpp"
+#include "TrivialSpec.hpp"
+#include "Model.hpp"
+#include "Set.hpp"
+#include "Vector.hpp"
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Hit counts of the entries of a model on a sample of inputs: hits[c][j] is the number
+ * of inputs for which entry j is the first entry of component c covering the input.
+ */
+using HitCounts = Vector<Vector<uint64_t>>;
+
+/**
+ * Runs the model on the given inputs (each given as the set of input variables set to true),
+ * evaluating F1 64 inputs at a time, and counts the hits of every entry with first-match semantics.
+ * Throws if some input is not covered by the model.
+ */
+HitCounts countHits(const Model& model, const TrivialSpec& f1, const Vector<Set<BVar>>& inputs);
+
+/** Average number of entries scanned per input, over all components, for the given counts */
+double meanScanLength(const HitCounts& hits);
+
+/**
+ * Reorders the list of every component by decreasing hit count (stable, so entries
+ * with equal counts keep their order). Any entry covering an input gives a correct
+ * output, so the model stays correct.
+ */
+void orderByHits(Model& model, const HitCounts& hits);
+
+/**
+ * Reads a trace of inputs, one per line, each given as a list of literals over the
+ * input variables terminated by 0 as in DIMACS (variables not listed are false).
+ */
+Vector<Set<BVar>> readTrace(const std::string& path);
+
+/** Uniformly random inputs over the given input variables, reproducible from the seed */
+Vector<Set<BVar>> randomInputs(const Set<BVar>& inputVars, size_t count, uint64_t seed = 0);
@@ -0,0 +1,147 @@
+#include "ReadInput.hpp"
+
+#include <fstream>
+#include <stdexcept>
+#include <tuple>
+
+using std::runtime_error;
+using std::string;
+using std::istream;
+using std::ifstream;
+using std::tuple;
+using std::make_tuple;
+using std::get;
+using std::move;
+
+/**
+ * Skip all comment lines.
+ */
+void skipComments(istream& in)
+{
+  string line;
+
+  while (in.peek() == 'c')
+  {
+      getline(in, line);
+  }
+
+  if (in.eof())
+  {
+      throw runtime_error("Unexpected end of file while reading DIMACS file");
+  }
+}
+
+/**
+ * Reads header of DIMACS file in format (p cnf <var-count> <clause-count>).
+ */
+tuple<int, int> readHeader(istream& in)
+{
+  string p, cnf;
+  in >> p >> cnf;
+
+  if (p != "p" && cnf != "cnf")
+  {
+    throw runtime_error("Incorrect format of DIMACS file: expected \"p cnf\", got \"" +
+	  p + " " + cnf + "\"");
+  }
+
+  size_t varCount, clauseCount;
+  in >> varCount >> clauseCount;
+
+  return make_tuple(varCount, clauseCount);
+}
+
+/**
+ * Reads list of quantified variables from the input string.
+ */
+Set<BVar> readQuantifiedVars(istream& in, const string& quantifier)
+{
+  string q;
+  in >> q;
+
+  /* Check that the quantifier is the one we expected */
+  if (q != quantifier)
+  {
+      throw runtime_error("Incorrect format of DIMACS file: expected \"" +
+			  quantifier + "\", got \"" + q + "\"");
+  }
+
+  Set<BVar> vars;
+  
+  BVar v;
+  in >> v;
+
+  /* Read variables until the 0 delimiter */
+  while (!in.eof() && v != 0)
+  {
+      vars.insert(v);
+      in >> v;
+  }
+
+  /* Error if file ended before finding a 0 */
+  if (in.eof())
+  {
+      throw runtime_error("Unexpected end of file while reading DIMACS file");
+  }
+
+  return vars;
+}
+
+/**
+ * Reads the given number of clauses from the input stream.
+ */
+CNFFormula readClauses(istream& in, size_t clauseCount)
+{
+  CNFFormula cnf;
+
+  for (size_t i = 0; i < clauseCount; i++)
+  {
+    CNFClause clause;
+
+    BLit lit;
+    in >> lit;
+
+    /* Read literals until the 0 delimiter */
+    while (!in.eof() && lit != 0)
+    {
+      clause |= lit;
+
+      in >> lit;
+    }
+
+    /* Error if file ended before finding a 0 */
+    if (lit != 0)
+    {
+      throw runtime_error("Unexpected end of file while reading DIMACS file");
+    }
+
+    cnf &= clause;
+  }
+
+  return cnf;
+}
+
+
+CNFSpec parseDIMACS(istream& in)
+{
+  skipComments(in);
+
+  size_t clauseCount = get<1>(readHeader(in)); /**< get only the number of clauses */
+
+  Set<BVar> inputVars = readQuantifiedVars(in, "a"); /**< read list of universal variables */ 
+  Set<BVar> outputVars = readQuantifiedVars(in, "e"); /**< read list of existential variables */
+
+  CNFFormula cnf = readClauses(in, clauseCount);
+
+  return CNFSpec(move(inputVars), move(outputVars), move(cnf));
+}
+
+CNFSpec loadDIMACS(const string& path)
+{
+  ifstream in(path);
+
+  if (!in.is_open())
+    throw runtime_error("Unable to open file " + path);
+
+  return parseDIMACS(in);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#include "Vector.hpp"
+
+/* Implementation in header file so that it can be accessed by code instantiating the template. */
+
+/**
+ * Bounded lock-free queue with exactly one producer thread and one consumer thread.
+ *
+ * The producer only writes _head and the consumer only writes _tail, so each
+ * index is published with a release store and read with an acquire load.
+ * One slot is always left empty to distinguish a full queue from an empty one.
+ */
+template <class T>
+class SPSCQueue
+{
+	Vector<T> _slots; /**< ring buffer holding the elements */
+	std::atomic<size_t> _head; /**< next slot to be written by the producer */
+	std::atomic<size_t> _tail; /**< next slot to be read by the consumer */
+
+public:
+
+	/** Constructs a queue holding at most the given number of elements */
+	SPSCQueue(size_t capacity)
+		: _slots(capacity + 1),
+		  _head(0),
+		  _tail(0)
+		{}
+
+	/** Called by the producer. Returns false (and leaves the element untouched) if the queue is full */
+	bool tryPush(T& element)
+		{
+			size_t head = _head.load(std::memory_order_relaxed);
+			size_t next = (head + 1) % _slots.size();
+
+			if (next == _tail.load(std::memory_order_acquire))
+				return false;
+
+			_slots[head] = std::move(element);
+			_head.store(next, std::memory_order_release);
+
+			return true;
+		}
+
+	/** Called by the consumer. Returns false if the queue is empty */
+	bool tryPop(T& element)
+		{
+			size_t tail = _tail.load(std::memory_order_relaxed);
+
+			if (tail == _head.load(std::memory_order_acquire))
+				return false;
+
+			element = std::move(_slots[tail]);
+			_tail.store((tail + 1) % _slots.size(), std::memory_order_release);
+
+			return true;
+		}
+};
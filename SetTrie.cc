@@ -0,0 +1,89 @@
+#include "SetTrie.hpp"
+
+#include <algorithm>
+
+using std::min;
+using std::pair;
+
+const size_t SetTrie::none;
+
+SetTrie::SetTrie()
+	: _nodes(1, Node{ {}, none })
+	, _size(0)
+{}
+
+void SetTrie::insert(const Set<BVar>& set, size_t index)
+{
+	size_t node = 0;
+
+	_nodes[node].minIndex = min(_nodes[node].minIndex, index);
+
+	for (BVar element : set)
+	{
+		Vector<pair<BVar, size_t>>& children = _nodes[node].children;
+
+		auto it = std::lower_bound(children.begin(), children.end(), element,
+		                           [] (const pair<BVar, size_t>& child, BVar e) { return child.first < e; });
+
+		if (it != children.end() && it->first == element)
+		{
+			node = it->second;
+		}
+		else
+		{
+			size_t child = _nodes.size();
+
+			/* Insert before reallocating the node vector, since children refers into it */
+			children.insert(it, { element, child });
+			_nodes.push_back(Node{ {}, none });
+
+			node = child;
+		}
+
+		_nodes[node].minIndex = min(_nodes[node].minIndex, index);
+	}
+
+	_size++;
+}
+
+void SetTrie::findSuperset(size_t node,
+                           const Vector<BVar>& query,
+                           size_t position,
+                           size_t& best) const
+{
+	if (_nodes[node].minIndex >= best)
+		return;
+
+	/* Every element of the query is on the path, so every set below contains it */
+	if (position == query.size())
+	{
+		best = _nodes[node].minIndex;
+		return;
+	}
+
+	for (const pair<BVar, size_t>& child : _nodes[node].children)
+	{
+		/* Sets below larger elements cannot contain query[position] */
+		if (child.first > query[position])
+			break;
+
+		size_t next = (child.first == query[position]) ? position + 1 : position;
+
+		findSuperset(child.second, query, next, best);
+	}
+}
+
+size_t SetTrie::findSuperset(const Set<BVar>& query) const
+{
+	Vector<BVar> elements(query.begin(), query.end());
+	size_t best = none;
+
+	findSuperset(0, elements, 0, best);
+
+	return best;
+}
+
+size_t SetTrie::size() const
+{
+	return _size;
+}
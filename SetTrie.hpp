@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CNFFormula.hpp"
+#include "Set.hpp"
+#include "Vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/**
+ * Index over a family of sets of variables answering superset queries.
+ *
+ * Every set is stored as the path of its elements in increasing order. A query
+ * walks the trie in order, skipping elements that are not in the query and
+ * stopping at the first element greater than the next query element, which
+ * prunes most of the family. Sets are identified by an index (e.g. their position
+ * in a decision list), and every node keeps the smallest index below it, so the
+ * search for the first superset of a query stops as soon as no subtree can improve it.
+ */
+class SetTrie
+{
+	struct Node
+	{
+		Vector<std::pair<BVar, size_t>> children; /*< (element, node) sorted by element */
+		size_t minIndex; /*< smallest index of a set in the subtree */
+	};
+
+	Vector<Node> _nodes; /*< _nodes[0] is the root */
+	size_t _size; /*< number of sets inserted */
+
+	void findSuperset(size_t node,
+	                  const Vector<BVar>& query,
+	                  size_t position,
+	                  size_t& best) const;
+
+public:
+
+	/** Returned by findSuperset when no set contains the query */
+	static const size_t none = SIZE_MAX;
+
+	SetTrie();
+
+	/** Adds a set to the family, identified by the given index */
+	void insert(const Set<BVar>& set, size_t index);
+
+	/** Returns the smallest index of a set containing the query, or none */
+	size_t findSuperset(const Set<BVar>& query) const;
+
+	/** Number of sets in the family */
+	size_t size() const;
+};
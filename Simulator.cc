@@ -0,0 +1,146 @@
+#include "Simulator.hpp"
+
+#include <random>
+
+using std::mt19937_64;
+
+Simulator::Simulator(const TrivialSpec& f1)
+{
+	f1.forEach([this] (BVar, const CNFClause& negDefinition)
+	{
+		Vector<int> definition;
+
+		for (BLit lit : negDefinition)
+		{
+			BVar var = abs(lit);
+
+			if (_inputIndex.find(var) == _inputIndex.end())
+			{
+				_inputIndex[var] = _inputs.size();
+				_inputs.push_back(var);
+			}
+
+			int k = _inputIndex[var] + 1;
+			definition.push_back((lit > 0) ? k : -k);
+		}
+
+		_definitions.push_back(definition);
+	});
+}
+
+const Vector<BVar>& Simulator::inputs() const
+{
+	return _inputs;
+}
+
+size_t Simulator::definitionCount() const
+{
+	return _definitions.size();
+}
+
+Vector<uint64_t> Simulator::simulate(const Vector<uint64_t>& inputWords) const
+{
+	Vector<size_t> all(_definitions.size());
+
+	for (size_t i = 0; i < all.size(); i++)
+		all[i] = i;
+
+	return simulate(inputWords, all);
+}
+
+Vector<uint64_t> Simulator::simulate(const Vector<uint64_t>& inputWords,
+                                     const Vector<size_t>& definitions) const
+{
+	Vector<uint64_t> result(definitions.size());
+
+	for (size_t d = 0; d < definitions.size(); d++)
+	{
+		/* z_i is true in the lanes where every literal of X_i is false */
+		uint64_t lanes = ~uint64_t(0);
+
+		for (int lit : _definitions[definitions[d]])
+		{
+			uint64_t word = inputWords[abs(lit) - 1];
+			lanes &= (lit > 0) ? ~word : word;
+		}
+
+		result[d] = lanes;
+	}
+
+	return result;
+}
+
+Vector<size_t> Simulator::cone(const Vector<size_t>& definitions) const
+{
+	Set<size_t> positions;
+
+	for (size_t i : definitions)
+		for (int lit : _definitions[i])
+			positions.insert(abs(lit) - 1);
+
+	return Vector<size_t>(positions.begin(), positions.end());
+}
+
+Vector<uint64_t> Simulator::exhaustiveStimulus(const Vector<size_t>& cone, size_t block) const
+{
+	/* Bit k of the lane index, for k < 6 */
+	static const uint64_t laneBits[6] =
+	{
+		0xAAAAAAAAAAAAAAAAull, 0xCCCCCCCCCCCCCCCCull, 0xF0F0F0F0F0F0F0F0ull,
+		0xFF00FF00FF00FF00ull, 0xFFFF0000FFFF0000ull, 0xFFFFFFFF00000000ull
+	};
+
+	Vector<uint64_t> words(_inputs.size(), 0);
+
+	for (size_t k = 0; k < cone.size(); k++)
+	{
+		if (k < 6)
+			words[cone[k]] = laneBits[k];
+		else
+			words[cone[k]] = ((block >> (k - 6)) & 1) ? ~uint64_t(0) : 0;
+	}
+
+	return words;
+}
+
+Vector<uint64_t> Simulator::stimulus(size_t round, uint64_t seed) const
+{
+	Vector<uint64_t> words(_inputs.size());
+
+	if (round == 0)
+	{
+		/* Lane 0 is all-false, lane 1 all-true, lanes 2-32 and 33-63 are bits of k and their complements */
+		for (size_t k = 0; k < words.size(); k++)
+		{
+			uint64_t word = uint64_t(1) << 1;
+
+			for (size_t b = 0; b < 31; b++)
+			{
+				bool bit = (k >> b) & 1;
+				word |= uint64_t(bit) << (2 + b);
+				word |= uint64_t(!bit) << (33 + b);
+			}
+
+			words[k] = word;
+		}
+	}
+	else
+	{
+		mt19937_64 rng(seed + round);
+
+		for (uint64_t& word : words)
+			word = rng();
+	}
+
+	return words;
+}
+
+Vector<Vector<uint64_t>> Simulator::simulateRounds(size_t rounds, uint64_t seed) const
+{
+	Vector<Vector<uint64_t>> result;
+
+	for (size_t r = 0; r < rounds; r++)
+		result.push_back(simulate(stimulus(r, seed)));
+
+	return result;
+}
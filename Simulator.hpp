@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CNFFormula.hpp"
+#include "TrivialSpec.hpp"
+#include "Vector.hpp"
+#include "Map.hpp"
+
+#include <cstdint>
+
+/**
+ * Bit-parallel evaluator of F1: (z_1 <-> ~X_1) /\ ... /\ (z_n <-> ~X_n).
+ *
+ * Every input variable is given a 64-bit word holding its value in 64 independent
+ * assignments (lanes), and every z_i is computed for all lanes at once with word
+ * operations. The set of z_i true in a lane is the set of clauses X_i falsified by
+ * that input, which the synthesized function has to cover.
+ */
+class Simulator
+{
+	Vector<BVar> _inputs; /*< input variables occurring in F1 */
+	Map<BVar, size_t> _inputIndex; /*< _inputIndex[x] == k iff _inputs[k] == x */
+	Vector<Vector<int>> _definitions; /*< X_1, ..., X_n over input indices, literal +(k + 1) or -(k + 1) */
+
+public:
+
+	Simulator(const TrivialSpec& f1);
+
+	/** Input variables, in the order expected by simulate */
+	const Vector<BVar>& inputs() const;
+
+	/** Number of definitions z_i */
+	size_t definitionCount() const;
+
+	/**
+	 * Evaluates F1 on 64 assignments, where inputWords[k] holds the values of inputs()[k].
+	 * Returns a word for every z_i with the lanes where z_i is true (X_i is falsified).
+	 */
+	Vector<uint64_t> simulate(const Vector<uint64_t>& inputWords) const;
+
+	/** Same as the above, restricted to the definitions with the given indices (in that order) */
+	Vector<uint64_t> simulate(const Vector<uint64_t>& inputWords,
+	                          const Vector<size_t>& definitions) const;
+
+	/** Positions in inputs() of the input variables occurring in the given definitions, sorted */
+	Vector<size_t> cone(const Vector<size_t>& definitions) const;
+
+	/**
+	 * Input words for block b of an exhaustive enumeration of the inputs at the given positions:
+	 * lane l of block b holds assignment 64 * b + l, whose bit k is the value of input cone[k].
+	 * Inputs outside the cone are false. 2^(cone.size() - 6) blocks (at least one) cover all assignments.
+	 */
+	Vector<uint64_t> exhaustiveStimulus(const Vector<size_t>& cone, size_t block) const;
+
+	/**
+	 * Input words for the given round of simulation. Round 0 is structured (all-false,
+	 * all-true and the bits of the input indices with their complements), later rounds
+	 * are pseudo-random, reproducible from the seed.
+	 */
+	Vector<uint64_t> stimulus(size_t round, uint64_t seed = 0) const;
+
+	/** Returns simulate(stimulus(r)) for every round r < rounds */
+	Vector<Vector<uint64_t>> simulateRounds(size_t rounds, uint64_t seed = 0) const;
+};
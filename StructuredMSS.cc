@@ -0,0 +1,314 @@
+#include "StructuredMSS.hpp"
+
+#include <algorithm>
+#include <utility>
+
+using std::move;
+using std::stable_sort;
+using std::min;
+
+ClauseStructure classifyClauses(const Vector<CNFClause>& clauses)
+{
+	bool twoCNF = true;
+	bool horn = true;
+
+	for (const CNFClause& clause : clauses)
+	{
+		size_t size = 0;
+		size_t positive = 0;
+
+		for (BLit lit : clause)
+		{
+			size++;
+
+			if (lit > 0)
+				positive++;
+		}
+
+		twoCNF = twoCNF && size <= 2;
+		horn = horn && positive <= 1;
+	}
+
+	if (twoCNF)
+		return ClauseStructure::TwoCNF;
+	else if (horn)
+		return ClauseStructure::Horn;
+	else
+		return ClauseStructure::General;
+}
+
+StructuredMSS::StructuredMSS(ClauseStructure structure,
+                             Vector<BVar> indicators,
+                             const Vector<CNFClause>& clauses)
+	: _structure(structure)
+	, _indicators(move(indicators))
+	, _clauses(clauses.size())
+{
+	Map<BVar, size_t> localIndex;
+
+	for (size_t i = 0; i < clauses.size(); i++)
+	{
+		for (BLit lit : clauses[i])
+		{
+			BVar var = abs(lit);
+
+			if (localIndex.find(var) == localIndex.end())
+			{
+				localIndex[var] = _localVars.size();
+				_localVars.push_back(var);
+			}
+
+			int local = localIndex[var] + 1;
+			_clauses[i].push_back((lit > 0) ? local : -local);
+		}
+	}
+}
+
+bool StructuredMSS::satisfiable(const Vector<size_t>& active, Vector<bool>& model) const
+{
+	if (_structure == ClauseStructure::TwoCNF)
+		return satisfiable2CNF(active, model);
+	else
+		return satisfiableHorn(active, model);
+}
+
+/**
+ * 2-SAT through the implication graph: literal l is node 2v for v and 2v + 1 for ~v,
+ * and a clause (a | b) gives the edges ~a -> b and ~b -> a. The clauses are
+ * satisfiable iff no variable shares a strongly connected component with its negation.
+ */
+bool StructuredMSS::satisfiable2CNF(const Vector<size_t>& active, Vector<bool>& model) const
+{
+	size_t nodes = 2 * _localVars.size();
+	Vector<Vector<size_t>> edges(nodes);
+
+	auto node = [] (int lit) { return 2 * (size_t)(abs(lit) - 1) + (lit < 0 ? 1 : 0); };
+
+	for (size_t i : active)
+	{
+		const Vector<int>& clause = _clauses[i];
+
+		if (clause.empty())
+			return false;
+
+		int a = clause[0];
+		int b = (clause.size() == 1) ? clause[0] : clause[1]; /*< (a) is the same as (a | a) */
+
+		edges[node(-a)].push_back(node(b));
+		edges[node(-b)].push_back(node(a));
+	}
+
+	/* Iterative Tarjan: components are numbered in reverse topological order */
+	const size_t unvisited = nodes;
+	Vector<size_t> index(nodes, unvisited), lowlink(nodes, 0), component(nodes, unvisited);
+	Vector<bool> onStack(nodes, false);
+	Vector<size_t> stack;
+	Vector<std::pair<size_t, size_t>> callStack; /*< (node, next edge to visit) */
+	size_t counter = 0, componentCount = 0;
+
+	for (size_t root = 0; root < nodes; root++)
+	{
+		if (index[root] != unvisited)
+			continue;
+
+		callStack.emplace_back(root, 0);
+		index[root] = lowlink[root] = counter++;
+		stack.push_back(root);
+		onStack[root] = true;
+
+		while (!callStack.empty())
+		{
+			size_t v = callStack.back().first;
+			size_t& next = callStack.back().second;
+
+			if (next < edges[v].size())
+			{
+				size_t w = edges[v][next++];
+
+				if (index[w] == unvisited)
+				{
+					index[w] = lowlink[w] = counter++;
+					stack.push_back(w);
+					onStack[w] = true;
+					callStack.emplace_back(w, 0);
+				}
+				else if (onStack[w])
+				{
+					lowlink[v] = min(lowlink[v], index[w]);
+				}
+			}
+			else
+			{
+				/* v is the root of a component: pop it */
+				if (lowlink[v] == index[v])
+				{
+					size_t w;
+
+					do
+					{
+						w = stack.back();
+						stack.pop_back();
+						onStack[w] = false;
+						component[w] = componentCount;
+					}
+					while (w != v);
+
+					componentCount++;
+				}
+
+				callStack.pop_back();
+
+				if (!callStack.empty())
+				{
+					size_t parent = callStack.back().first;
+					lowlink[parent] = min(lowlink[parent], lowlink[v]);
+				}
+			}
+		}
+	}
+
+	model.assign(_localVars.size(), false);
+
+	for (size_t v = 0; v < _localVars.size(); v++)
+	{
+		if (component[2 * v] == component[2 * v + 1])
+			return false;
+
+		/* A literal is set to true if its component comes later in topological order */
+		model[v] = component[2 * v] < component[2 * v + 1];
+	}
+
+	return true;
+}
+
+/**
+ * Horn-SAT: start with every variable false and set a variable to true only when
+ * some clause forces it (all its negative literals are false). The clauses are
+ * satisfiable iff no clause ends up with every literal false.
+ */
+bool StructuredMSS::satisfiableHorn(const Vector<size_t>& active, Vector<bool>& model) const
+{
+	model.assign(_localVars.size(), false);
+
+	Vector<size_t> remaining(active.size()); /*< negative literals of each clause whose variable is not true yet */
+	Vector<Vector<size_t>> occurrences(_localVars.size()); /*< clauses where the variable occurs negatively */
+	Vector<size_t> queue; /*< variables set to true whose occurrences were not processed yet */
+
+	/* Sets the head of a clause whose negative literals are all false, returning false on conflict */
+	auto fire = [&] (size_t c)
+	{
+		for (int lit : _clauses[active[c]])
+		{
+			if (lit > 0)
+			{
+				size_t v = lit - 1;
+
+				if (!model[v])
+				{
+					model[v] = true;
+					queue.push_back(v);
+				}
+
+				return true;
+			}
+		}
+
+		return false; /*< clause has no positive literal */
+	};
+
+	for (size_t c = 0; c < active.size(); c++)
+	{
+		for (int lit : _clauses[active[c]])
+		{
+			if (lit < 0)
+			{
+				remaining[c]++;
+				occurrences[-lit - 1].push_back(c);
+			}
+		}
+	}
+
+	for (size_t c = 0; c < active.size(); c++)
+		if (remaining[c] == 0 && !fire(c))
+			return false;
+
+	while (!queue.empty())
+	{
+		size_t v = queue.back();
+		queue.pop_back();
+
+		for (size_t c : occurrences[v])
+			if (--remaining[c] == 0 && !fire(c))
+				return false;
+	}
+
+	return true;
+}
+
+Optional<Set<BVar>> StructuredMSS::newMSSCovering(const Set<BVar>& vars,
+                                                  const Map<BVar, uint64_t>& weights) const
+{
+	Vector<size_t> active;
+	Vector<size_t> candidates;
+
+	for (size_t i = 0; i < _indicators.size(); i++)
+	{
+		if (vars.find(_indicators[i]) != vars.end())
+			active.push_back(i);
+		else
+			candidates.push_back(i);
+	}
+
+	Vector<bool> model;
+
+	if (!satisfiable(active, model))
+		return nullopt;
+
+	/* Try the indicators with larger weight first */
+	auto weightOf = [this, &weights] (size_t i)
+	{
+		auto it = weights.find(_indicators[i]);
+		return (it != weights.end()) ? it->second : 1;
+	};
+
+	stable_sort(candidates.begin(), candidates.end(),
+	            [&weightOf] (size_t i, size_t j) { return weightOf(i) > weightOf(j); });
+
+	/* True if the clause with the given index is satisfied by the current model */
+	auto satisfiedByModel = [this, &model] (size_t i)
+	{
+		for (int lit : _clauses[i])
+			if (model[abs(lit) - 1] == (lit > 0))
+				return true;
+
+		return false;
+	};
+
+	for (size_t i : candidates)
+	{
+		active.push_back(i);
+
+		/* No need to solve if the current model already satisfies the new clause */
+		if (satisfiedByModel(i))
+			continue;
+
+		Vector<bool> extended;
+
+		if (satisfiable(active, extended))
+			model = move(extended);
+		else
+			active.pop_back();
+	}
+
+	/* Represent MSS by the indicators it contains and the output variables set to true */
+	Set<BVar> mss;
+
+	for (size_t i : active)
+		mss.insert(_indicators[i]);
+
+	for (size_t v = 0; v < _localVars.size(); v++)
+		if (model[v])
+			mss.insert(_localVars[v]);
+
+	return mss;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CNFFormula.hpp"
+#include "Set.hpp"
+#include "Map.hpp"
+#include "Vector.hpp"
+#include "Optional.hpp"
+
+#include <cstdint>
+
+/**
+ * Syntactic classes of output clauses for which satisfiability is polynomial.
+ */
+enum class ClauseStructure
+{
+	General, /**< no particular structure, requires a MaxSAT solver */
+	TwoCNF,  /**< every clause has at most two literals */
+	Horn     /**< every clause has at most one positive literal */
+};
+
+/** Returns the most specific class containing all the given clauses (2-CNF is preferred over Horn) */
+ClauseStructure classifyClauses(const Vector<CNFClause>& clauses);
+
+/**
+ * Computes MSS of output clauses that are 2-CNF or Horn without a MaxSAT solver.
+ *
+ * An MSS containing a given set is obtained by starting from that set and trying to
+ * add every other indicator in turn, keeping it if the clauses stay satisfiable.
+ * Since every subset of a satisfiable set is satisfiable, an indicator rejected
+ * once can never be added later, so the result is maximal. Every check is linear:
+ * strongly connected components of the implication graph for 2-CNF, and unit
+ * propagation from the all-false assignment for Horn clauses.
+ */
+class StructuredMSS
+{
+	ClauseStructure _structure;
+
+	Vector<BVar> _indicators; /*< z_1, ..., z_n */
+	Vector<Vector<int>> _clauses; /*< Y_1, ..., Y_n over local variables, literal +(v + 1) or -(v + 1) */
+	Vector<BVar> _localVars; /*< _localVars[v] is the output variable represented by local variable v */
+
+	/**
+	 * Checks if the conjunction of the clauses with the given indices is satisfiable,
+	 * storing a satisfying assignment (over local variables) in model if it is.
+	 */
+	bool satisfiable(const Vector<size_t>& active, Vector<bool>& model) const;
+
+	bool satisfiable2CNF(const Vector<size_t>& active, Vector<bool>& model) const;
+	bool satisfiableHorn(const Vector<size_t>& active, Vector<bool>& model) const;
+
+public:
+
+	/** Constructs an MSS engine for the clauses (z_i -> Y_i), which must belong to the given class */
+	StructuredMSS(ClauseStructure structure,
+	              Vector<BVar> indicators,
+	              const Vector<CNFClause>& clauses);
+
+	/**
+	 * Generate an MSS containing the given indicators, or nothing if they are not satisfiable.
+	 * Indicators with larger weight are tried first (indicators missing from weights have weight 1).
+	 * The MSS is represented by the set of Z and Y variables set to true.
+	 */
+	Optional<Set<BVar>> newMSSCovering(const Set<BVar>& vars,
+	                                   const Map<BVar, uint64_t>& weights = Map<BVar, uint64_t>()) const;
+};
@@ -0,0 +1,16 @@
+#include "Synthesis.hpp"
+#include "CNFDecomp.hpp"
+#include "Algorithm.hpp"
+
+#include <utility>
+
+Synthesis synthesize(const CNFSpec& spec, const SynthesisOptions& options, bool minimize)
+{
+	CNFChain chain = cnfDecomp(spec);
+	Model model = BAFConnectedComponents(chain.first, chain.second, options);
+
+	if (minimize)
+		minimizeModel(model, chain.first, chain.second, options);
+
+	return Synthesis { std::move(chain), std::move(model) };
+}
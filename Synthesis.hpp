@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CNFSpec.hpp"
+#include "CNFChain.hpp"
+#include "Model.hpp"
+#include "SynthesisOptions.hpp"
+
+/**
+ * In-process synthesis API, the entry point of libbafsyn.
+ *
+ * Synthesis keeps no global state: every call builds its own SAT and MaxSAT solvers from
+ * the options it is given, so calls on different specifications may run concurrently.
+ * The options of the bafsyn command line are only read by its main function.
+ */
+
+/** Synthesized function, with the decomposition (F1, F2) its entries refer to */
+struct Synthesis
+{
+	CNFChain chain;
+	Model model;
+};
+
+/**
+ * Decomposes the specification and synthesizes a function for it, minimizing the decision
+ * lists afterwards if requested. Throws Unrealizable if the specification is unrealizable.
+ */
+Synthesis synthesize(const CNFSpec& spec, const SynthesisOptions& options = SynthesisOptions(), bool minimize = false);
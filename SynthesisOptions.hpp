@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+
+class ComponentCache;
+class PreviousRun;
+class Checkpoint;
+
+/**
+ * Parameters of the WBO MaxSAT solver computing the MSS (same meaning as in open-wbo).
+ */
+struct MaxSATOptions
+{
+	/** Verbosity level (0 = minimal, 1 = more) */
+	int verbosity = 0;
+
+	/** Weight strategy (0 = none, 1 = weight-based, 2 = diversity-based) */
+	int weightStrategy = 2;
+
+	/** Symmetry breaking */
+	bool symmetry = true;
+
+	/** Limit on the number of symmetry breaking clauses */
+	int symmetryLimit = 500000;
+};
+
+/**
+ * Thrown by the synthesis algorithm when it is cancelled through SynthesisOptions::cancel.
+ */
+struct SynthesisCancelled : std::runtime_error
+{
+	SynthesisCancelled() : std::runtime_error("Synthesis cancelled") {}
+};
+
+/**
+ * Thrown by the synthesis algorithm when some MFS has no MSS, i.e. the specification is unrealizable.
+ */
+struct Unrealizable : std::invalid_argument
+{
+	Unrealizable() : std::invalid_argument("Specification is unrealizable!") {}
+};
+
+/**
+ * Options controlling the behavior of the synthesis algorithm.
+ * Default values run the original back-and-forth algorithm, except that tiny components are
+ * solved by enumeration (tinyComponentSize) and 2-CNF or Horn components get their MSS without
+ * MaxSAT (structuredMSS). Both still produce lists of exact MSS; setting tinyComponentSize to 0 and
+ * structuredMSS to false gives the original algorithm exactly.
+ */
+struct SynthesisOptions
+{
+	/** Reweight soft indicator clauses toward indicators likely to appear in uncovered MFS */
+	bool coverageWeights = false;
+
+	/** Number of recent MSS used to estimate the coverage weights */
+	std::size_t coverageWindow = 4;
+
+	/** Components with at most this many indicators are solved by enumeration (at most tinyComponentLimit) */
+	std::size_t tinyComponentSize = 8;
+
+	/** Compute MSS without MaxSAT for components whose output clauses are 2-CNF or Horn */
+	bool structuredMSS = true;
+
+	/** Generate MFS in a separate thread, running ahead of the MSS computation */
+	bool pipeline = false;
+
+	/** Maximum number of MFS the producer thread may run ahead */
+	std::size_t pipelineDepth = 64;
+
+	/** Number of threads used on a single large component (1 disables cube-and-conquer) */
+	std::size_t cubeWorkers = 1;
+
+	/** Number of indicators the cubes are split over (0 chooses from the number of workers) */
+	std::size_t cubeVars = 0;
+
+	/** Minimum number of indicators in a component for it to be split into cubes */
+	std::size_t cubeMinIndicators = 64;
+
+	/** Replace MaxSAT calls by a single SAT call with greedy growth (entries need not be maximal) */
+	bool approximate = false;
+
+	/** Rounds of 64 simulated inputs whose falsified sets are covered before the SAT-driven loop */
+	std::size_t simulationRounds = 0;
+
+	/** Switch between MFS-driven search and direct MSS enumeration depending on measured costs */
+	bool adaptive = false;
+
+	/** Components whose definitions depend on at most this many inputs are solved by input enumeration (0 disables) */
+	std::size_t coneSize = 0;
+
+	/** Components isomorphic to a component solved before reuse its list, renamed (see Isomorphism.hpp) */
+	bool reuseIsomorphic = false;
+
+	/** Components with more indicators are not checked for isomorphism */
+	std::size_t isomorphismLimit = 2000;
+
+	/**
+	 * If not null, components are looked up in this cache before being solved, and the
+	 * lists of those not found are stored in it (only components within isomorphismLimit)
+	 */
+	const ComponentCache* cache = nullptr;
+
+	/**
+	 * If not null, unchanged components reuse the list of the previous run, and the back-and-forth
+	 * loop of changed components starts from the previous entries that are still valid
+	 */
+	const PreviousRun* previous = nullptr;
+
+	/**
+	 * If not null, the lists found so far are written to this checkpoint between MSS
+	 * computations, and the components it restored are not synthesized again
+	 */
+	Checkpoint* checkpoint = nullptr;
+
+	/** Maximum number of MFS enumerated by minimizeModel for a minimum cover */
+	std::size_t minimizeMFSLimit = 500;
+
+	/** Irredundant lists with at most this many MSS get a minimum cover by minimizeModel */
+	std::size_t minimizeExactSize = 32;
+
+	/** Parameters of the MaxSAT solver */
+	MaxSATOptions maxsat;
+
+	/**
+	 * If not null, synthesis throws SynthesisCancelled once *cancel is true. The flag is
+	 * checked before every MSS computation and every component, not during solver calls.
+	 */
+	const std::atomic<bool>* cancel = nullptr;
+};
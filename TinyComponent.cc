@@ -0,0 +1,253 @@
+#include "TinyComponent.hpp"
+#include "Map.hpp"
+#include "SynthesisOptions.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+
+using std::count_if;
+
+namespace
+{
+	/** Literal over local variables: +(v + 1) or -(v + 1) */
+	using LocalLit = int;
+
+	/** Truth value of a local variable: 0 if unassigned, 1 if true, -1 if false */
+	using Value = int8_t;
+
+	Value litValue(LocalLit lit, const Vector<Value>& values)
+	{
+		Value v = values[abs(lit) - 1];
+
+		return (lit > 0) ? v : -v;
+	}
+
+	/**
+	 * DPLL with unit propagation over the given clauses.
+	 * Returns true if satisfiable, in which case values holds a satisfying partial assignment.
+	 */
+	bool dpll(const Vector<const Vector<LocalLit>*>& clauses, Vector<Value>& values)
+	{
+		/* Unit propagation until fixpoint */
+		bool changed = true;
+
+		while (changed)
+		{
+			changed = false;
+
+			for (const Vector<LocalLit>* clause : clauses)
+			{
+				LocalLit unassigned = 0;
+				size_t unassignedCount = 0;
+				bool satisfied = false;
+
+				for (LocalLit lit : *clause)
+				{
+					Value v = litValue(lit, values);
+
+					if (v > 0)
+					{
+						satisfied = true;
+						break;
+					}
+					else if (v == 0)
+					{
+						unassigned = lit;
+						unassignedCount++;
+					}
+				}
+
+				if (satisfied)
+					continue;
+
+				if (unassignedCount == 0) /*< every literal is false */
+					return false;
+
+				if (unassignedCount == 1) /*< unit clause */
+				{
+					values[abs(unassigned) - 1] = (unassigned > 0) ? 1 : -1;
+					changed = true;
+				}
+			}
+		}
+
+		/* Branch on an unassigned literal of some clause that is not satisfied yet */
+		for (const Vector<LocalLit>* clause : clauses)
+		{
+			bool satisfied = false;
+			LocalLit branch = 0;
+
+			for (LocalLit lit : *clause)
+			{
+				Value v = litValue(lit, values);
+
+				if (v > 0)
+					satisfied = true;
+				else if (v == 0 && branch == 0)
+					branch = lit;
+			}
+
+			if (satisfied)
+				continue;
+
+			for (Value choice : { Value(1), Value(-1) })
+			{
+				Vector<Value> attempt = values;
+				attempt[abs(branch) - 1] = (branch > 0) ? choice : Value(-choice);
+
+				if (dpll(clauses, attempt))
+				{
+					values = attempt;
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		return true; /*< every clause is satisfied */
+	}
+}
+
+Vector<Set<BVar>> tinyComponentMSS(const Vector<BVar>& indicators,
+                                   const Vector<CNFClause>& clauses,
+                                   const Graph<size_t>& conflictGraph)
+{
+	size_t n = indicators.size();
+	uint32_t all = (uint32_t(1) << n) - 1;
+
+	/* conflicts[i] has bit j set iff z_i and z_j cannot be in the same MFS */
+	Vector<uint32_t> conflicts(n, 0);
+
+	for (size_t i = 0; i < n; i++)
+		for (size_t j = 0; j < n; j++)
+			if (conflictGraph.edgeExists(conflictGraph.vertexByIndex(i), conflictGraph.vertexByIndex(j)))
+				conflicts[i] |= uint32_t(1) << j;
+
+	/* Translate output clauses to local variables 0, ..., m - 1 */
+	Map<BVar, size_t> localIndex;
+	Vector<BVar> localVars;
+	Vector<Vector<LocalLit>> localClauses(n);
+
+	for (size_t i = 0; i < n; i++)
+		for (BLit lit : clauses[i])
+		{
+			BVar var = abs(lit);
+
+			if (localIndex.find(var) == localIndex.end())
+			{
+				localIndex[var] = localVars.size();
+				localVars.push_back(var);
+			}
+
+			LocalLit local = localIndex[var] + 1;
+			localClauses[i].push_back((lit > 0) ? local : -local);
+		}
+
+	/*
+	 * Satisfiability of every subset of indicators. Satisfiable subsets are closed
+	 * under subsets, so a subset is only checked if all subsets with one fewer
+	 * element are satisfiable (masks are visited in increasing order, so those
+	 * were already checked).
+	 */
+	Vector<bool> satisfiable(all + 1, false);
+	Vector<Vector<Value>> models(all + 1);
+
+	for (uint32_t mask = 0; mask <= all; mask++)
+	{
+		bool candidate = true;
+
+		for (size_t i = 0; i < n && candidate; i++)
+			if ((mask >> i) & 1)
+				candidate = satisfiable[mask & ~(uint32_t(1) << i)];
+
+		if (!candidate)
+			continue;
+
+		Vector<const Vector<LocalLit>*> active;
+
+		for (size_t i = 0; i < n; i++)
+			if ((mask >> i) & 1)
+				active.push_back(&localClauses[i]);
+
+		Vector<Value> values(localVars.size(), 0);
+
+		if (dpll(active, values))
+		{
+			satisfiable[mask] = true;
+			models[mask] = values;
+		}
+	}
+
+	/* MSS: satisfiable sets that cannot be extended. MFS: independent sets that cannot be extended. */
+	Vector<uint32_t> mssMasks;
+	Vector<uint32_t> uncovered;
+
+	for (uint32_t mask = 0; mask <= all; mask++)
+	{
+		bool maximalSat = satisfiable[mask];
+		bool independent = true;
+		bool maximalIndependent = true;
+
+		for (size_t i = 0; i < n; i++)
+		{
+			uint32_t bit = uint32_t(1) << i;
+
+			if (mask & bit)
+			{
+				independent = independent && !(conflicts[i] & mask);
+			}
+			else
+			{
+				maximalSat = maximalSat && !satisfiable[mask | bit];
+				maximalIndependent = maximalIndependent && (conflicts[i] & (mask | bit));
+			}
+		}
+
+		if (maximalSat)
+			mssMasks.push_back(mask);
+
+		if (independent && maximalIndependent)
+		{
+			if (!satisfiable[mask])
+				throw Unrealizable();
+
+			uncovered.push_back(mask);
+		}
+	}
+
+	/* Greedily pick the MSS covering the most uncovered MFS */
+	Vector<Set<BVar>> result;
+
+	while (!uncovered.empty())
+	{
+		auto coveredBy = [&uncovered] (uint32_t mss)
+		{
+			return count_if(uncovered.begin(), uncovered.end(),
+			                [mss] (uint32_t mfs) { return (mfs & ~mss) == 0; });
+		};
+
+		uint32_t best = *std::max_element(mssMasks.begin(), mssMasks.end(),
+		                                  [&coveredBy] (uint32_t a, uint32_t b) { return coveredBy(a) < coveredBy(b); });
+
+		uncovered.erase(std::remove_if(uncovered.begin(), uncovered.end(),
+		                               [best] (uint32_t mfs) { return (mfs & ~best) == 0; }),
+		                uncovered.end());
+
+		/* Represent MSS by the indicators it contains and the output variables set to true */
+		Set<BVar> mss;
+
+		for (size_t i = 0; i < n; i++)
+			if ((best >> i) & 1)
+				mss.insert(indicators[i]);
+
+		for (size_t v = 0; v < localVars.size(); v++)
+			if (models[best][v] > 0)
+				mss.insert(localVars[v]);
+
+		result.push_back(mss);
+	}
+
+	return result;
+}
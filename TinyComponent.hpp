@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CNFFormula.hpp"
+#include "Graph.hpp"
+#include "Set.hpp"
+#include "Vector.hpp"
+
+/**
+ * Computes the MSS list of a component small enough for all subsets of its
+ * indicators to be enumerated, without building any SAT or MaxSAT solver.
+ *
+ * - indicators: z_1, ..., z_n, with n at most tinyComponentLimit.
+ * - clauses: Y_1, ..., Y_n.
+ * - conflictGraph: conflict graph of the component, where vertex i represents z_i.
+ *
+ * Every MFS (maximal independent set of the conflict graph) is covered by one of the
+ * returned MSS, which are chosen greedily to cover as many MFS as possible each.
+ * MSS are represented in the same way as in MSSGenerator: by the set of z and y
+ * variables set to true. Throws Unrealizable if some MFS is not satisfiable, which only
+ * happens if the specification is unrealizable.
+ */
+Vector<Set<BVar>> tinyComponentMSS(const Vector<BVar>& indicators,
+                                   const Vector<CNFClause>& clauses,
+                                   const Graph<size_t>& conflictGraph);
+
+/** Maximum number of indicators accepted by tinyComponentMSS */
+const size_t tinyComponentLimit = 16;
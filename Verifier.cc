@@ -26,6 +26,7 @@ We present several methods for (1) and a simple method for (2).
 */
 
 #include "Verifier.hpp"
+#include <algorithm>
 #include <iostream>
 #include <random>
 
@@ -176,7 +177,9 @@ bool Verifier::checkIfCovered(const Set<BVar>& inputAssignment) const
 		bool foundMSSCover = false;
 
 		/* ...and look for an MSS that covers the restricted assignment */
-		for (const Set<BVar>& mss : model.mssForComponent(i))
+		const Vector<Set<BVar>>& mssList = model.mssForComponent(i);
+
+		for (const Set<BVar>& mss : mssList)
 		{
 			foundMSSCover = isSubset(restrictedAssignment, mss);
 
@@ -193,6 +196,24 @@ bool Verifier::checkIfCovered(const Set<BVar>& inputAssignment) const
 			}
 		}
 
+		/*
+		 * The scan above does not use the cover index of the model (set-trie, or ZDD after
+		 * buildZDD), so that a bug in the index fails verification instead of hiding itself
+		 */
+		Optional<Set<BVar>> indexed = model.coveringMSS(i, restrictedAssignment);
+
+		if (static_cast<bool>(indexed) != foundMSSCover ||
+		    (indexed && (!isSubset(restrictedAssignment, *indexed) ||
+		                 std::find(mssList.begin(), mssList.end(), *indexed) == mssList.end())))
+		{
+#if MYDEBUG >=1
+			cout << "Cover index disagrees with the list for ";
+			print(restrictedAssignment, "z");
+			cout << endl;
+#endif
+			return false;
+		}
+
 		if (!foundMSSCover)
 		{
                     #if MYDEBUG >=1
@@ -275,3 +296,65 @@ bool Verifier::RandomVerifyInputCover() const
 #endif
 	return ok;
 }
+
+bool Verifier::verifyEvaluation(std::function<Set<BVar>(const Set<BVar>&)> eval) const
+{
+	/* The outputs must satisfy the specification */
+	auto check = [this, &eval] (const Set<BVar>& inputAssignment)
+	{
+		try
+		{
+			Set<BVar> assignment = inputAssignment;
+
+			for (BVar y : eval(inputAssignment))
+				assignment.insert(y);
+
+			return f.cnf().eval(assignment);
+		}
+		catch (const std::runtime_error&) /*< input not covered */
+		{
+			return false;
+		}
+	};
+
+	if (f.inputVars().size() <= 15)
+	{
+		Set<BVar> inputVars = f.inputVars();
+		Set<BVar> potentialAssignment;
+
+		return forAllAssignments(potentialAssignment, inputVars, check);
+	}
+
+	random_device rd;
+	mt19937 rng(rd());
+
+	size_t sampleSize = 500; // number of sample assignments taken
+	bool ok = true;
+
+	for (size_t i = 0; i < sampleSize; i++)
+		ok &= check(randomSubset(f.inputVars(), rng));
+
+	return ok;
+}
+
+bool Verifier::VerifyCompiledModel(const CompiledModel& compiled) const
+{
+#if MYDEBUG >=1
+	cout << "Verifying compiled model" << endl;
+#endif
+	return verifyEvaluation([&compiled] (const Set<BVar>& inputAssignment)
+	{
+		return compiled.eval(inputAssignment);
+	});
+}
+
+bool Verifier::VerifyMappedModel(const MappedModel& mapped) const
+{
+#if MYDEBUG >=1
+	cout << "Verifying mapped model" << endl;
+#endif
+	return verifyEvaluation([&mapped] (const Set<BVar>& inputAssignment)
+	{
+		return mapped.eval(inputAssignment);
+	});
+}
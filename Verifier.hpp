@@ -34,6 +34,8 @@ We present several methods for (1) and a simple method for (2).
 #include "Printing.hpp"
 #include "CNFChain.hpp"
 #include "Model.hpp"
+#include "CompiledModel.hpp"
+#include "ModelFile.hpp"
 
 #include <list>
 #include <functional>
@@ -49,6 +51,9 @@ class Verifier
 
 	bool checkIfCovered(const Set<BVar>& assignment) const;
 
+	/** Checks the outputs of an evaluator of the model against the specification, as VerifyCompiledModel */
+	bool verifyEvaluation(std::function<Set<BVar>(const Set<BVar>&)> eval) const;
+
 public:
 
 Verifier(Model model, CNFSpec f, CNFChain cnfChain);
@@ -62,4 +67,10 @@ bool VerifyMSSList() const;
 bool VerifyInputCover() const;
 
 bool RandomVerifyInputCover() const;
+
+//Checks that the outputs computed by the compiled model satisfy the specification, on all inputs if there are at most 15 input variables and on a random sample otherwise.
+bool VerifyCompiledModel(const CompiledModel& compiled) const;
+
+//Same check for a model file mapped in memory.
+bool VerifyMappedModel(const MappedModel& mapped) const;
 };
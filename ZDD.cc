@@ -0,0 +1,252 @@
+#include "ZDD.hpp"
+
+#include <limits>
+#include <utility>
+
+using std::numeric_limits;
+
+namespace
+{
+	const uint32_t emptyFamily = 0; /*< {} */
+	const uint32_t unitFamily = 1; /*< {{}} */
+
+	uint64_t pairKey(uint64_t a, uint64_t b)
+	{
+		return (a << 32) | b;
+	}
+
+	uint64_t nodeHash(BVar var, uint32_t lo, uint32_t hi)
+	{
+		return (uint64_t(uint32_t(var)) * 0x9E3779B97F4A7C15ull) ^ pairKey(lo, hi);
+	}
+}
+
+ZDD::ZDD()
+	: _nodes(2, Node{ numeric_limits<BVar>::max(), 0, 0 })
+	, _root(emptyFamily)
+{}
+
+ZDD::ZDD(const Vector<Set<BVar>>& sets)
+	: ZDD()
+{
+	for (const Set<BVar>& set : sets)
+		insert(set);
+
+	compact();
+}
+
+void ZDD::compact()
+{
+	/* Nodes reachable from the root, children always have smaller indices than their parents */
+	Vector<bool> reachable(_nodes.size(), false);
+	reachable[emptyFamily] = reachable[unitFamily] = true;
+	reachable[_root] = true;
+
+	for (size_t i = _nodes.size(); i-- > 2; )
+	{
+		if (reachable[i])
+			reachable[_nodes[i].lo] = reachable[_nodes[i].hi] = true;
+	}
+
+	Vector<uint32_t> renamed(_nodes.size());
+	Vector<Node> nodes;
+
+	for (size_t i = 0; i < _nodes.size(); i++)
+	{
+		if (!reachable[i])
+			continue;
+
+		renamed[i] = nodes.size();
+
+		Node node = _nodes[i];
+
+		if (i >= 2)
+		{
+			node.lo = renamed[node.lo];
+			node.hi = renamed[node.hi];
+		}
+
+		nodes.push_back(node);
+	}
+
+	_root = renamed[_root];
+	_nodes = std::move(nodes);
+
+	_unique.clear();
+
+	for (size_t i = 2; i < _nodes.size(); i++)
+		_unique[nodeHash(_nodes[i].var, _nodes[i].lo, _nodes[i].hi)].push_back(i);
+}
+
+BVar ZDD::topVar(uint32_t node) const
+{
+	return _nodes[node].var;
+}
+
+uint32_t ZDD::makeNode(BVar var, uint32_t lo, uint32_t hi)
+{
+	/* Zero-suppression rule */
+	if (hi == emptyFamily)
+		return lo;
+
+	Vector<uint32_t>& bucket = _unique[nodeHash(var, lo, hi)];
+
+	for (uint32_t node : bucket)
+		if (_nodes[node].var == var && _nodes[node].lo == lo && _nodes[node].hi == hi)
+			return node;
+
+	uint32_t node = _nodes.size();
+	_nodes.push_back(Node{ var, lo, hi });
+	bucket.push_back(node);
+
+	return node;
+}
+
+uint32_t ZDD::unite(uint32_t a, uint32_t b, Map<uint64_t, uint32_t>& memo)
+{
+	if (a == emptyFamily || a == b)
+		return b;
+
+	if (b == emptyFamily)
+		return a;
+
+	/* Union is commutative, memoize on the ordered pair */
+	if (a > b)
+		std::swap(a, b);
+
+	uint64_t key = pairKey(a, b);
+	auto it = memo.find(key);
+
+	if (it != memo.end())
+		return it->second;
+
+	BVar va = topVar(a);
+	BVar vb = topVar(b);
+
+	uint32_t result;
+
+	if (va < vb)
+		result = makeNode(va, unite(_nodes[a].lo, b, memo), _nodes[a].hi);
+	else if (vb < va)
+		result = makeNode(vb, unite(a, _nodes[b].lo, memo), _nodes[b].hi);
+	else
+		result = makeNode(va, unite(_nodes[a].lo, _nodes[b].lo, memo), unite(_nodes[a].hi, _nodes[b].hi, memo));
+
+	memo[key] = result;
+
+	return result;
+}
+
+void ZDD::insert(const Set<BVar>& set)
+{
+	/* Chain of the single set, built from its largest variable up */
+	uint32_t chain = unitFamily;
+
+	for (auto it = set.rbegin(); it != set.rend(); ++it)
+		chain = makeNode(*it, emptyFamily, chain);
+
+	Map<uint64_t, uint32_t> memo;
+	_root = unite(_root, chain, memo);
+}
+
+bool ZDD::findSuperset(uint32_t node,
+                       const Vector<BVar>& query,
+                       size_t position,
+                       Set<uint64_t>& failed,
+                       Vector<BVar>& path) const
+{
+	if (node == emptyFamily)
+		return false;
+
+	if (position == query.size())
+	{
+		/* Any set below will do, follow the lo edges down to the empty set */
+		while (node != unitFamily)
+		{
+			if (_nodes[node].lo != emptyFamily)
+			{
+				node = _nodes[node].lo;
+			}
+			else
+			{
+				path.push_back(_nodes[node].var);
+				node = _nodes[node].hi;
+			}
+		}
+
+		return true;
+	}
+
+	/* Variables increase along paths, query[position] cannot appear below */
+	if (node == unitFamily || topVar(node) > query[position])
+		return false;
+
+	uint64_t key = pairKey(node, position);
+
+	if (failed.find(key) != failed.end())
+		return false;
+
+	const Node& n = _nodes[node];
+
+	if (n.var == query[position])
+	{
+		path.push_back(n.var);
+
+		if (findSuperset(n.hi, query, position + 1, failed, path))
+			return true;
+
+		path.pop_back();
+	}
+	else
+	{
+		if (findSuperset(n.lo, query, position, failed, path))
+			return true;
+
+		path.push_back(n.var);
+
+		if (findSuperset(n.hi, query, position, failed, path))
+			return true;
+
+		path.pop_back();
+	}
+
+	failed.insert(key);
+
+	return false;
+}
+
+Optional<Set<BVar>> ZDD::findSuperset(const Set<BVar>& query) const
+{
+	Vector<BVar> elements(query.begin(), query.end());
+	Set<uint64_t> failed;
+	Vector<BVar> path;
+
+	if (!findSuperset(_root, elements, 0, failed, path))
+		return nullopt;
+
+	return Set<BVar>(path.begin(), path.end());
+}
+
+bool ZDD::containsSuperset(const Set<BVar>& query) const
+{
+	return static_cast<bool>(findSuperset(query));
+}
+
+size_t ZDD::nodeCount() const
+{
+	return _nodes.size() - 2;
+}
+
+uint64_t ZDD::setCount() const
+{
+	/* Number of paths to the unit terminal, counted bottom-up (children have smaller indices) */
+	Vector<uint64_t> count(_nodes.size());
+
+	count[emptyFamily] = 0;
+	count[unitFamily] = 1;
+
+	for (size_t i = 2; i < _nodes.size(); i++)
+		count[i] = count[_nodes[i].lo] + count[_nodes[i].hi];
+
+	return count[_root];
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "CNFFormula.hpp"
+#include "Set.hpp"
+#include "Vector.hpp"
+#include "Map.hpp"
+#include "Optional.hpp"
+
+#include <cstdint>
+
+/**
+ * Zero-suppressed decision diagram representing a family of sets of variables.
+ *
+ * Node (v, lo, hi) represents the sets of lo (not containing v) together with the sets
+ * of hi with v added; variables increase along every path, and nodes whose hi child is
+ * the empty family are never created, so sets sharing prefixes and suffixes share nodes.
+ * Node 0 is the empty family and node 1 the family containing only the empty set.
+ *
+ * Superset queries walk the diagram with memoization, so their cost is bounded by the
+ * number of nodes times the size of the query rather than by the number of sets.
+ */
+class ZDD
+{
+	struct Node
+	{
+		BVar var;
+		uint32_t lo;
+		uint32_t hi;
+	};
+
+	Vector<Node> _nodes;
+	Map<uint64_t, Vector<uint32_t>> _unique; /*< nodes by hash of (var, lo, hi) */
+	uint32_t _root;
+
+	/** Returns the node (v, lo, hi), creating it if needed */
+	uint32_t makeNode(BVar var, uint32_t lo, uint32_t hi);
+
+	/** Family union */
+	uint32_t unite(uint32_t a, uint32_t b, Map<uint64_t, uint32_t>& memo);
+
+	/** Variable of a node, larger than every variable for the terminals */
+	BVar topVar(uint32_t node) const;
+
+	/** Whether some set below node contains query[position..], adding its variables to path if so */
+	bool findSuperset(uint32_t node,
+	                  const Vector<BVar>& query,
+	                  size_t position,
+	                  Set<uint64_t>& failed,
+	                  Vector<BVar>& path) const;
+
+public:
+
+	/** Constructs the empty family */
+	ZDD();
+
+	/** Constructs the family of the given sets, keeping only the nodes that are needed */
+	ZDD(const Vector<Set<BVar>>& sets);
+
+	/** Adds a set to the family (the nodes of the previous family are kept until the next compaction) */
+	void insert(const Set<BVar>& set);
+
+	/** Removes the nodes no longer reachable from the root (left over by insert) */
+	void compact();
+
+	/** Returns a set of the family containing the query, or nothing if there is none */
+	Optional<Set<BVar>> findSuperset(const Set<BVar>& query) const;
+
+	/** Whether some set of the family contains the query */
+	bool containsSuperset(const Set<BVar>& query) const;
+
+	/** Number of internal nodes */
+	size_t nodeCount() const;
+
+	/** Number of sets in the family */
+	uint64_t setCount() const;
+};
@@ -0,0 +1,332 @@
+/**
+ * bafsyn-eval: evaluates a model saved by bafsyn -save-model on a stream of inputs.
+ *
+ * Inputs are read in batches; every batch is split among the threads, which parse,
+ * evaluate and format their share of it, and the outputs are written in input order.
+ *
+ * Text format (default): one input per line, as DIMACS literals over the input variables
+ * terminated by 0 (variables not listed are false); empty lines and lines starting with 'c'
+ * are skipped. Every output line lists all output variables as literals, terminated by 0.
+ *
+ * Binary format (-binary): every input is ceil(I / 8) bytes, where bit k % 8 of byte k / 8
+ * is the value of input k (inputs by increasing variable, I inputs); every output is
+ * ceil(O / 8) bytes with the same layout.
+ */
+
+#include "ModelFile.hpp"
+#include "utils/Options.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using NSPACE::IntOption;
+using NSPACE::BoolOption;
+using NSPACE::StringOption;
+using NSPACE::IntRange;
+using NSPACE::parseOptions;
+using NSPACE::setUsageHelp;
+using std::string;
+using std::runtime_error;
+using std::chrono::steady_clock;
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+
+namespace
+{
+	/** Evaluates the inputs of a batch, one share per thread */
+	class BatchEvaluator
+	{
+		const MappedModel& _model;
+		bool _binary;
+		size_t _inputBytes;
+		size_t _outputBytes;
+		Vector<int32_t> _positionOf; /*< position of every input variable, -1 for other variables */
+		Vector<string> _trueLit; /*< "y " for every output y */
+		Vector<string> _falseLit; /*< "-y " for every output y */
+
+		void evalText(const string& line, Vector<uint8_t>& x, Vector<uint8_t>& y, string& out) const
+		{
+			std::fill(x.begin(), x.end(), 0);
+
+			const char* p = line.c_str();
+			char* end;
+
+			for (long lit = std::strtol(p, &end, 10); end != p && lit != 0; lit = std::strtol(p, &end, 10))
+			{
+				long var = std::labs(lit);
+
+				if (var >= long(_positionOf.size()) || _positionOf[var] < 0)
+					throw runtime_error("Not an input variable: " + std::to_string(var));
+
+				x[_positionOf[var]] = (lit > 0);
+				p = end;
+			}
+
+			_model.eval(x.data(), y.data());
+
+			for (size_t k = 0; k < y.size(); k++)
+				out += y[k] ? _trueLit[k] : _falseLit[k];
+
+			out += "0\n";
+		}
+
+		void evalBinary(const uint8_t* record, Vector<uint8_t>& x, Vector<uint8_t>& y, string& out) const
+		{
+			for (size_t k = 0; k < x.size(); k++)
+				x[k] = (record[k / 8] >> (k % 8)) & 1;
+
+			_model.eval(x.data(), y.data());
+
+			size_t offset = out.size();
+			out.resize(offset + _outputBytes, 0);
+
+			for (size_t k = 0; k < y.size(); k++)
+				out[offset + k / 8] |= char(y[k] << (k % 8));
+		}
+
+	public:
+
+		BatchEvaluator(const MappedModel& model, bool binary)
+			: _model(model), _binary(binary),
+			  _inputBytes((model.inputCount() + 7) / 8), _outputBytes((model.outputCount() + 7) / 8)
+		{
+			for (size_t k = 0; k < model.inputCount(); k++)
+			{
+				uint32_t var = model.inputVars()[k];
+
+				if (var >= _positionOf.size())
+					_positionOf.resize(var + 1, -1);
+
+				_positionOf[var] = k;
+			}
+
+			for (size_t k = 0; k < model.outputCount(); k++)
+			{
+				string var = std::to_string(model.outputVars()[k]);
+
+				_trueLit.push_back(var + " ");
+				_falseLit.push_back("-" + var + " ");
+			}
+		}
+
+		size_t inputBytes() const
+		{
+			return _inputBytes;
+		}
+
+		/** Evaluates inputs [begin, end) of the batch, appending their outputs to out */
+		void run(const Vector<string>& lines, const Vector<uint8_t>& records,
+		         size_t begin, size_t end, string& out) const
+		{
+			Vector<uint8_t> x(_model.inputCount());
+			Vector<uint8_t> y(_model.outputCount());
+
+			for (size_t i = begin; i < end; i++)
+			{
+				if (_binary)
+					evalBinary(records.data() + i * _inputBytes, x, y, out);
+				else
+					evalText(lines[i], x, y, out);
+			}
+		}
+	};
+
+	/** Reads up to count input lines, skipping comments and empty lines */
+	void readLines(FILE* in, size_t count, Vector<string>& lines)
+	{
+		char* buffer = nullptr;
+		size_t capacity = 0;
+		ssize_t length;
+
+		lines.clear();
+
+		while (lines.size() < count && (length = getline(&buffer, &capacity, in)) >= 0)
+		{
+			size_t first = std::strspn(buffer, " \t\r\n");
+
+			if (buffer[first] == '\0' || buffer[first] == 'c')
+				continue;
+
+			lines.emplace_back(buffer, length);
+		}
+
+		std::free(buffer);
+	}
+
+	/** Reads up to count binary inputs, returns the number read */
+	size_t readRecords(FILE* in, size_t count, size_t recordBytes, Vector<uint8_t>& records)
+	{
+		if (recordBytes == 0)
+			throw runtime_error("The binary format needs a model with inputs");
+
+		records.resize(count * recordBytes);
+
+		size_t bytes = std::fread(records.data(), 1, records.size(), in);
+
+		if (bytes % recordBytes != 0)
+			throw runtime_error("Truncated binary input");
+
+		return bytes / recordBytes;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	setUsageHelp("USAGE: %s [options] <model-file> [<input-file>]\n\n"
+	              "  Evaluates a model saved by bafsyn -save-model on every input of the input file (default: standard input).\n");
+
+	IntOption threads("EVAL", "threads",
+	                  "Number of evaluation threads (0 = one per core).\n", 0,
+	                  IntRange(0, INT32_MAX));
+
+	IntOption batchSize("EVAL", "batch",
+	                    "Number of inputs read and evaluated at a time.\n", 65536,
+	                    IntRange(1, INT32_MAX));
+
+	BoolOption binary("EVAL", "binary",
+	                  "Read and write packed bits instead of DIMACS text.\n", false);
+
+	StringOption outputPath("EVAL", "output",
+	                        "Write the outputs to this file instead of standard output.\n");
+
+	BoolOption stats("EVAL", "stats",
+	                 "Print the number of inputs and the throughput to standard error.\n", false);
+
+	parseOptions(argc, argv, true);
+
+	if (argc < 2)
+	{
+		std::cerr << "Expected format: " << argv[0] << " [options] <model-file> [<input-file>]" << std::endl;
+		return 1;
+	}
+
+	FILE* in = stdin;
+	FILE* out = stdout;
+
+	try
+	{
+		MappedModel model(argv[1]);
+		BatchEvaluator evaluator(model, binary);
+
+		if (argc > 2 && string(argv[2]) != "-")
+		{
+			in = std::fopen(argv[2], binary ? "rb" : "r");
+
+			if (!in)
+				throw runtime_error(string("Could not open ") + argv[2]);
+		}
+
+		if (outputPath)
+		{
+			out = std::fopen(outputPath, binary ? "wb" : "w");
+
+			if (!out)
+				throw runtime_error("Could not open " + string(outputPath));
+		}
+
+		/* Output is written in large blocks, one per thread and batch */
+		std::setvbuf(out, nullptr, _IOFBF, 1 << 20);
+
+		size_t threadCount = (threads > 0) ? size_t(threads) : std::max(1u, std::thread::hardware_concurrency());
+
+		Vector<string> lines;
+		Vector<uint8_t> records;
+		Vector<string> results(threadCount);
+		Vector<std::exception_ptr> errors(threadCount);
+		size_t total = 0;
+
+		auto start = steady_clock::now();
+
+		while (true)
+		{
+			size_t count;
+
+			if (binary)
+				count = readRecords(in, batchSize, evaluator.inputBytes(), records);
+			else
+			{
+				readLines(in, batchSize, lines);
+				count = lines.size();
+			}
+
+			if (count == 0)
+				break;
+
+			size_t shares = std::min(threadCount, count);
+			Vector<std::thread> workers;
+
+			for (size_t t = 0; t < shares; t++)
+			{
+				results[t].clear();
+				errors[t] = nullptr;
+
+				auto work = [&, t] ()
+				{
+					try
+					{
+						evaluator.run(lines, records, count * t / shares, count * (t + 1) / shares, results[t]);
+					}
+					catch (...)
+					{
+						errors[t] = std::current_exception();
+					}
+				};
+
+				if (t + 1 < shares)
+					workers.emplace_back(work);
+				else
+					work(); /*< the last share is evaluated by this thread */
+			}
+
+			for (std::thread& worker : workers)
+				worker.join();
+
+			for (size_t t = 0; t < shares; t++)
+			{
+				if (errors[t])
+					std::rethrow_exception(errors[t]);
+
+				std::fwrite(results[t].data(), 1, results[t].size(), out);
+			}
+
+			total += count;
+
+			if (count < size_t(batchSize))
+				break;
+		}
+
+		if (std::fflush(out) != 0)
+			throw runtime_error("Could not write the outputs");
+
+		auto time = duration_cast<milliseconds>(steady_clock::now() - start);
+
+		if (stats)
+		{
+			std::cerr << "Evaluated " << total << " inputs in " << time.count() << "ms";
+
+			if (time.count() > 0)
+				std::cerr << " (" << uint64_t(total * 1000.0 / time.count()) << " inputs/s)";
+
+			std::cerr << " with " << threadCount << " threads" << std::endl;
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	if (in != stdin)
+		std::fclose(in);
+	if (out != stdout)
+		std::fclose(out);
+
+	return 0;
+}